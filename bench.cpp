@@ -0,0 +1,620 @@
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "graphs.h"
+#include "idset.h"
+#include "bloom.h"
+#include "dg.h"
+#include "critical.h"
+#include "dag.h"
+#include "tree.h"
+#include "cg.h"
+#include "components.h"
+#include "pagerank.h"
+#include "intersect.h"
+#include "reorder.h"
+#include "compressed.h"
+#include "ingest.h"
+#include "msbfs.h"
+#include "subgraph.h"
+#include "succinct.h"
+
+using std::cout;
+using std::make_pair;
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// A graph with num_edges edges between uniformly random vertices in
+// [0, num_vertices).
+DirectedGraph random_graph(int num_vertices, size_t num_edges, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> pick(0, num_vertices - 1);
+  DirectedGraph dg;
+  for (size_t i = 0; i < num_edges; i++) {
+    Vertex u(make_pair("v", pick(rng)));
+    Vertex v(make_pair("v", pick(rng)));
+    dg.add_edge(&u, &v);
+  }
+  return dg;
+}
+
+// A side x side grid (edges to the right and down neighbors) whose vertex
+// ids and edge order are shuffled, so that neighbors in the grid end up
+// far apart in memory.
+DirectedGraph shuffled_grid(int side, unsigned seed) {
+  std::mt19937 rng(seed);
+  vector<int> ids(side * side);
+  for (size_t i = 0; i < ids.size(); i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), rng);
+  vector<std::pair<int, int>> edges;
+  for (int row = 0; row < side; row++) {
+    for (int col = 0; col < side; col++) {
+      if (col + 1 < side) {
+	edges.push_back(make_pair(ids[row * side + col], ids[row * side + col + 1]));
+      }
+      if (row + 1 < side) {
+	edges.push_back(make_pair(ids[row * side + col], ids[(row + 1) * side + col]));
+      }
+    }
+  }
+  std::shuffle(edges.begin(), edges.end(), rng);
+  DirectedGraph dg;
+  for (auto& edge : edges) {
+    Vertex u(make_pair("v", edge.first));
+    Vertex v(make_pair("v", edge.second));
+    dg.add_edge(&u, &v);
+  }
+  return dg;
+}
+
+// The straightforward way to do it with the existing API: walk a copy
+// of the adjacency list and union-find over a std::map.
+int sequential_components(DirectedGraph& dg) {
+  std::map<int, int> parent;
+  auto find = [&](int x) {
+    while (parent[x] != x) {
+      parent[x] = parent[parent[x]];
+      x = parent[x];
+    }
+    return x;
+  };
+  for (const Edge& e : dg.get_adjacency_list()) {
+    int u = e.get_source()->value().second;
+    parent.insert(make_pair(u, u));
+    if (e.get_dest()) {
+      int v = e.get_dest()->value().second;
+      parent.insert(make_pair(v, v));
+      int root_u = find(u);
+      int root_v = find(v);
+      if (root_u != root_v) {
+	parent[std::max(root_u, root_v)] = std::min(root_u, root_v);
+      }
+    }
+  }
+  int num_components = 0;
+  for (auto& entry : parent) {
+    if (entry.first == entry.second) {
+      num_components++;
+    }
+  }
+  return num_components;
+}
+
+// The same union-find on the dense indices of a CompactGraph, over a flat
+// parent array, on one thread.
+int flat_components(const CompactGraph& cg) {
+  vector<int> parent(cg.vertex_count());
+  for (size_t v = 0; v < parent.size(); v++) {
+    parent[v] = v;
+  }
+  auto find = [&](int x) {
+    while (parent[x] != x) {
+      parent[x] = parent[parent[x]];
+      x = parent[x];
+    }
+    return x;
+  };
+  for (size_t e = 0; e < cg.edge_count(); e++) {
+    int root_u = find(cg.source(e));
+    int root_v = find(cg.dest(e));
+    if (root_u != root_v) {
+      parent[std::max(root_u, root_v)] = std::min(root_u, root_v);
+    }
+  }
+  int num_components = 0;
+  for (size_t v = 0; v < parent.size(); v++) {
+    if (parent[v] == int(v)) {
+      num_components++;
+    }
+  }
+  return num_components;
+}
+
+void bench_components(int num_vertices, size_t num_edges) {
+  cout << "connected components: " << num_vertices << " vertices, " << num_edges << " edges\n";
+  DirectedGraph dg = random_graph(num_vertices, num_edges, 1);
+
+  Clock::time_point start = Clock::now();
+  int expected = sequential_components(dg);
+  double baseline = seconds_since(start);
+  cout << "  sequential (get_adjacency_list): " << baseline << " s, " << expected << " components\n";
+
+  start = Clock::now();
+  CompactGraph cg = graph_lib::compact(dg);
+  double compaction = seconds_since(start);
+  cout << "  compact: " << compaction << " s\n";
+
+  start = Clock::now();
+  assert(flat_components(cg) == expected);
+  double flat = seconds_since(start);
+  cout << "  sequential (flat array): " << flat << " s\n";
+  // Against the flat array, the ratio measures parallelism alone; against
+  // the std::map walk, it includes compaction, which the walk also pays for
+  // in its copy of the adjacency list.
+  for (int num_threads : {1, 2, 4, 8}) {
+    start = Clock::now();
+    vector<int> labels = graph_lib::component_labels(cg, num_threads);
+    double elapsed = seconds_since(start);
+    int num_components = 0;
+    for (int v = 0; v < cg.vertex_count(); v++) {
+      if (labels[v] == v) {
+	num_components++;
+      }
+    }
+    assert(num_components == expected);
+    cout << "  union-find, " << num_threads << " threads: " << elapsed << " s ("
+	 << flat / elapsed << "x flat array, " << baseline / (compaction + elapsed)
+	 << "x std::map with compaction)\n";
+  }
+}
+
+void bench_pagerank(int num_vertices, size_t num_edges) {
+  cout << "pagerank: " << num_vertices << " vertices, " << num_edges << " edges\n";
+  DirectedGraph dg = random_graph(num_vertices, num_edges, 2);
+  CompactGraph cg = graph_lib::compact(dg);
+  for (int num_threads : {1, 2, 4, 8}) {
+    PropagationOptions options;
+    options.num_threads = num_threads;
+    vector<float> ranks;
+    PropagationStats stats = graph_lib::pagerank(cg, ranks, 0.85, options);
+    cout << "  " << num_threads << " threads: " << stats.iterations << " iterations, "
+	 << stats.seconds_per_iteration() * 1000 << " ms/iteration, "
+	 << stats.edges_per_second(cg.edge_count()) / 1e6 << " M edges/s\n";
+  }
+}
+
+void bench_intersect(int num_vertices, size_t num_edges) {
+  cout << "intersect / triangles: " << num_vertices << " vertices, " << num_edges << " edges\n";
+  DirectedGraph dg = random_graph(num_vertices, num_edges, 3);
+  NeighborIndex index = graph_lib::neighbor_index(dg);
+  const Adjacency& successors = index.successors();
+  int n = index.graph().vertex_count();
+
+  // All pairs (v, v + 1): many short intersections.
+  Clock::time_point start = Clock::now();
+  size_t scalar = 0;
+  for (int v = 0; v + 1 < n; v++) {
+    scalar += graph_lib::intersect_scalar(successors.begin(v), successors.degree(v),
+					  successors.begin(v + 1), successors.degree(v + 1));
+  }
+  double scalar_seconds = seconds_since(start);
+  start = Clock::now();
+  size_t vectorized = 0;
+  for (int v = 0; v + 1 < n; v++) {
+    vectorized += graph_lib::intersect(successors.begin(v), successors.degree(v),
+				       successors.begin(v + 1), successors.degree(v + 1));
+  }
+  double vectorized_seconds = seconds_since(start);
+  assert(scalar == vectorized);
+  cout << "  " << n - 1 << " intersections: scalar " << scalar_seconds << " s, vectorized "
+       << vectorized_seconds << " s (" << scalar_seconds / vectorized_seconds << "x)\n";
+
+  for (int num_threads : {1, 2, 4, 8}) {
+    start = Clock::now();
+    long triangles = index.count_triangles(num_threads);
+    cout << "  count_triangles, " << num_threads << " threads: " << seconds_since(start) << " s, "
+	 << triangles << " triangles\n";
+  }
+}
+
+void bench_reorder(int num_vertices) {
+  int side = std::sqrt(num_vertices);
+  cout << "reorder: shuffled " << side << " x " << side << " grid\n";
+  DirectedGraph dg = shuffled_grid(side, 4);
+  const char* names[] = {"first seen", "degree", "bfs", "rcm"};
+  int i = 0;
+  for (Ordering kind : {Ordering::kFirstSeen, Ordering::kDegree, Ordering::kBfs, Ordering::kReverseCuthillMcKee}) {
+    Clock::time_point start = Clock::now();
+    CompactGraph cg = graph_lib::compact(dg, kind);
+    double reorder_seconds = seconds_since(start);
+    Adjacency undirected = cg.undirected_edges();
+
+    // Whole-graph breadth-first traversals from vertex 0.
+    const int kRounds = 10;
+    start = Clock::now();
+    vector<int> order;
+    for (int round = 0; round < kRounds; round++) {
+      order = graph_lib::breadth_first_order(undirected, vector<int>(1, 0), false);
+    }
+    double bfs_seconds = seconds_since(start) / kRounds;
+
+    PropagationOptions options;
+    options.num_threads = 1;
+    options.max_iterations = 20;
+    options.tolerance = 0;
+    vector<float> ranks;
+    PropagationStats stats = graph_lib::pagerank(cg, ranks, 0.85, options);
+    cout << "  " << names[i++] << ": compact+reorder " << reorder_seconds << " s, bfs "
+	 << bfs_seconds * 1000 << " ms, pagerank " << stats.seconds_per_iteration() * 1000 << " ms/iteration\n";
+  }
+}
+
+void bench_compressed_graph(const char* label, DirectedGraph& dg) {
+  cout << "  " << label << ":\n";
+  // Every edge costs an Edge, two Vertex and a Value, each with a
+  // std::string, not counting allocator overhead.
+  double edge_bytes = sizeof(Edge) + 2 * sizeof(Vertex) + sizeof(Value);
+  Clock::time_point start = Clock::now();
+  long checksum = 0;
+  for (const Edge& e : dg.edges()) {
+    checksum += e.get_dest()->value().second;
+  }
+  double edge_seconds = seconds_since(start);
+  size_t num_edges = dg.edges().size();
+  cout << "    vector<Edge>: " << edge_bytes << " bytes/edge, " << num_edges / edge_seconds / 1e6
+       << " M edges/s\n";
+
+  CompactGraph cg = graph_lib::compact(dg, Ordering::kBfs);
+  Adjacency successors = cg.sorted_out_edges();
+  start = Clock::now();
+  long csr_checksum = 0;
+  for (int v = 0; v < cg.vertex_count(); v++) {
+    for (const int* w = successors.begin(v); w != successors.end(v); w++) {
+      csr_checksum += *w;
+    }
+  }
+  double csr_seconds = seconds_since(start);
+  cout << "    int CSR: " << double(sizeof(int)) << " bytes/edge, "
+       << successors.targets.size() / csr_seconds / 1e6 << " M edges/s\n";
+
+  CompressedGraph compressed(cg);
+  start = Clock::now();
+  long compressed_checksum = 0;
+  for (int v = 0; v < compressed.vertex_count(); v++) {
+    for (int w : compressed.neighbors(v)) {
+      compressed_checksum += w;
+    }
+  }
+  double compressed_seconds = seconds_since(start);
+  assert(compressed_checksum == csr_checksum);
+  cout << "    varint deltas: " << compressed.bytes_per_edge() << " bytes/edge ("
+       << double(compressed.bytes()) / compressed.edge_count() << " with offsets and labels), "
+       << compressed.edge_count() / compressed_seconds / 1e6 << " M edges/s\n";
+  // Keep the scans from being optimized away.
+  if (checksum == 42) {
+    cout << "";
+  }
+}
+
+void bench_compressed(int num_vertices, size_t num_edges) {
+  cout << "compressed adjacency:\n";
+  DirectedGraph random = random_graph(num_vertices, num_edges, 5);
+  bench_compressed_graph("random graph", random);
+  DirectedGraph grid = shuffled_grid(std::sqrt(num_vertices * 10), 5);
+  bench_compressed_graph("shuffled grid", grid);
+}
+
+void bench_ingest(int num_vertices, size_t num_edges) {
+  cout << "ingest: " << num_edges << " edges\n";
+  std::mt19937 rng(6);
+  std::uniform_int_distribution<int> pick(0, num_vertices - 1);
+  vector<std::pair<Value, Value>> pairs;
+  for (size_t i = 0; i < num_edges; i++) {
+    pairs.push_back(make_pair(Value(make_pair("v", pick(rng))), Value(make_pair("v", pick(rng)))));
+  }
+
+  Clock::time_point start = Clock::now();
+  {
+    DirectedGraph dg;
+    for (auto& pair : pairs) {
+      Vertex u(pair.first);
+      Vertex v(pair.second);
+      dg.add_edge(&u, &v);
+    }
+  }
+  double baseline = seconds_since(start);
+  cout << "  add_edge: " << num_edges / baseline / 1e6 << " M edges/s\n";
+  for (int num_threads : {1, 2, 4, 8}) {
+    start = Clock::now();
+    {
+      DirectedGraph dg;
+      graph_lib::load_edges(dg, pairs, num_threads);
+    }
+    double elapsed = seconds_since(start);
+    cout << "  load_edges, " << num_threads << " threads: " << num_edges / elapsed / 1e6 << " M edges/s ("
+	 << baseline / elapsed << "x)\n";
+  }
+}
+
+void bench_msbfs(int num_vertices, size_t num_edges) {
+  const int kSources = 1024;
+  cout << "multi-source bfs: " << kSources << " sources, " << num_vertices << " vertices, " << num_edges
+       << " edges\n";
+  DirectedGraph dg = random_graph(num_vertices, num_edges, 7);
+  CompactGraph cg = graph_lib::compact(dg);
+  Adjacency out = cg.out_edges();
+  vector<int> sources;
+  for (int i = 0; i < kSources; i++) {
+    sources.push_back(i * (cg.vertex_count() / kSources));
+  }
+
+  Clock::time_point start = Clock::now();
+  long reached = 0;
+  for (int source : sources) {
+    for (int distance : graph_lib::bfs_distances(out, source)) {
+      reached += distance >= 0;
+    }
+  }
+  double baseline = seconds_since(start);
+  cout << "  " << kSources << " x bfs_distances: " << baseline << " s\n";
+
+  start = Clock::now();
+  DistanceMatrix narrow = graph_lib::multi_source_bfs<1>(cg, sources, 1);
+  double narrow_seconds = seconds_since(start);
+  start = Clock::now();
+  DistanceMatrix wide = graph_lib::multi_source_bfs<4>(cg, sources, 1);
+  double wide_seconds = seconds_since(start);
+  long narrow_reached = 0;
+  for (size_t i = 0; i < narrow.distances.size(); i++) {
+    assert(narrow.distances[i] == wide.distances[i]);
+    narrow_reached += narrow.distances[i] >= 0;
+  }
+  assert(narrow_reached == reached);
+  cout << "  ms-bfs, 64 wide: " << narrow_seconds << " s (" << baseline / narrow_seconds << "x)\n";
+  cout << "  ms-bfs, 256 wide: " << wide_seconds << " s (" << baseline / wide_seconds << "x)\n";
+  for (int num_threads : {2, 4}) {
+    start = Clock::now();
+    graph_lib::multi_source_bfs<4>(cg, sources, num_threads);
+    double elapsed = seconds_since(start);
+    cout << "  ms-bfs, 256 wide, " << num_threads << " threads: " << elapsed << " s ("
+	 << baseline / elapsed << "x)\n";
+  }
+}
+
+void bench_adjacency_filter(int num_vertices, size_t num_edges) {
+  // Scanning queries are O(edges), so keep the graph small enough for
+  // the unfiltered baseline to finish.
+  num_edges = std::min<size_t>(num_edges, 100000);
+  const int kQueries = 2000;
+  cout << "are_adjacent, mostly negative: " << num_edges << " edges, " << kQueries << " queries\n";
+  DirectedGraph dg = random_graph(num_vertices, num_edges, 8);
+  std::mt19937 rng(9);
+  std::uniform_int_distribution<int> pick(0, num_vertices - 1);
+  vector<Vertex> vertices;
+  for (int i = 0; i < 2 * kQueries; i++) {
+    vertices.push_back(Vertex(make_pair("v", pick(rng))));
+  }
+  vector<std::pair<const Vertex*, const Vertex*>> pairs;
+  for (int i = 0; i < kQueries; i++) {
+    pairs.push_back(make_pair(&vertices[2 * i], &vertices[2 * i + 1]));
+  }
+
+  Clock::time_point start = Clock::now();
+  int baseline_hits = 0;
+  for (auto& pair : pairs) {
+    baseline_hits += dg.are_adjacent(pair.first, pair.second);
+  }
+  double baseline = seconds_since(start);
+  cout << "  scan: " << baseline / kQueries * 1e6 << " us/query, " << baseline_hits << " adjacent\n";
+
+  for (double rate : {0.1, 0.01, 0.001}) {
+    dg.set_adjacency_filter(rate);
+    dg.are_adjacent(pairs[0].first, pairs[0].second);
+    start = Clock::now();
+    int hits = 0;
+    for (auto& pair : pairs) {
+      hits += dg.are_adjacent(pair.first, pair.second);
+    }
+    double elapsed = seconds_since(start);
+    assert(hits == baseline_hits);
+    start = Clock::now();
+    vector<bool> adjacent = dg.are_adjacent(pairs);
+    double batch = seconds_since(start);
+    assert(std::count(adjacent.begin(), adjacent.end(), true) == baseline_hits);
+    cout << "  filter at " << rate << ": " << elapsed / kQueries * 1e6 << " us/query (" << baseline / elapsed
+	 << "x), batch " << batch / kQueries * 1e6 << " us/query (" << baseline / batch << "x)\n";
+  }
+}
+
+void bench_subgraph(int num_vertices, size_t num_edges) {
+  // The baseline calls get_neighbors() once per visited vertex, each an
+  // O(edges) scan, so keep the graph small enough for it to finish, and
+  // dense enough for the neighborhoods to grow.
+  num_edges = std::min<size_t>(num_edges, 100000);
+  num_vertices = std::min<int>(num_vertices, num_edges / 10);
+  const int kSeeds = 20, kHops = 2;
+  cout << kHops << "-hop subgraph: " << num_edges << " edges, " << kSeeds << " seeds\n";
+  DirectedGraph dg = random_graph(num_vertices, num_edges, 10);
+  vector<Vertex> seeds;
+  for (int i = 0; i < kSeeds; i++) {
+    seeds.push_back(Vertex(make_pair("v", i * (num_vertices / kSeeds))));
+  }
+
+  // One get_neighbors() call per frontier vertex, one add_edge() per edge.
+  Clock::time_point start = Clock::now();
+  DirectedGraph baseline;
+  std::unordered_set<int> seen;
+  vector<Vertex*> frontier;
+  for (Vertex& seed : seeds) {
+    if (seen.insert(seed.value().second).second) {
+      frontier.push_back(&seed);
+    }
+  }
+  vector<Vertex*> members = frontier;
+  for (int hop = 0; hop < kHops; hop++) {
+    vector<Vertex*> next;
+    for (Vertex* v : frontier) {
+      for (Vertex* w : dg.get_neighbors(v)) {
+	if (seen.insert(w->value().second).second) {
+	  next.push_back(w);
+	  members.push_back(w);
+	}
+      }
+    }
+    frontier.swap(next);
+  }
+  for (Vertex* v : members) {
+    for (Vertex* w : dg.get_neighbors(v)) {
+      if (seen.count(w->value().second)) {
+	baseline.add_edge(v, w);
+      }
+    }
+  }
+  double sequential = seconds_since(start);
+  cout << "  get_neighbors: " << sequential << " s, " << members.size() << " vertices, "
+       << baseline.edge_count() << " edges\n";
+
+  vector<Vertex*> seed_pointers;
+  for (Vertex& seed : seeds) {
+    seed_pointers.push_back(&seed);
+  }
+  for (int threads : {1, 2, 4}) {
+    start = Clock::now();
+    DirectedGraph subgraph = graph_lib::k_hop_subgraph(dg, seed_pointers, kHops, threads);
+    double elapsed = seconds_since(start);
+    assert(subgraph.edge_count() == baseline.edge_count());
+    cout << "  k_hop_subgraph, " << threads << " threads: " << elapsed << " s (" << sequential / elapsed << "x)\n";
+  }
+}
+
+void bench_succinct(int num_nodes) {
+  cout << "succinct tree: " << num_nodes << " nodes, random parents\n";
+  std::mt19937 rng(11);
+  vector<vector<Edge>> batches(1);
+  vector<int> parents(num_nodes, -1);
+  for (int i = 1; i < num_nodes; i++) {
+    parents[i] = std::uniform_int_distribution<int>(0, i - 1)(rng);
+    batches[0].push_back(Edge(std::make_unique<Vertex>(make_pair("v", parents[i])),
+			      std::make_unique<Vertex>(make_pair("v", i)),
+			      std::make_unique<Value>(kDummyValue)));
+  }
+  Tree tree;
+  tree.append_edges(batches);
+
+  // The pointer-based Tree answers children with get_neighbors() and
+  // parents with a scan of the edges, both O(edges) per query.
+  const int kQueries = 200;
+  vector<Vertex> queries;
+  for (int i = 0; i < kQueries; i++) {
+    queries.push_back(Vertex(make_pair("v", std::uniform_int_distribution<int>(1, num_nodes - 1)(rng))));
+  }
+  Clock::time_point start = Clock::now();
+  long checksum = 0;
+  for (Vertex& query : queries) {
+    checksum += tree.get_neighbors(&query).size();
+    for (const Edge& e : tree.edges()) {
+      if (e.get_dest() && *e.get_dest() == query) {
+	checksum += e.get_source()->value().second;
+	break;
+      }
+    }
+  }
+  double pointer_seconds = seconds_since(start);
+  double edge_bytes = sizeof(Edge) + 2 * sizeof(Vertex) + sizeof(Value);
+  cout << "  Tree: " << edge_bytes << " bytes/node, children + parent "
+       << pointer_seconds / kQueries * 1e6 << " us/query\n";
+
+  start = Clock::now();
+  SuccinctTree succinct = graph_lib::succinct(tree);
+  double build_seconds = seconds_since(start);
+  vector<int> nodes;
+  for (Vertex& query : queries) {
+    nodes.push_back(succinct.find(query.value().second));
+  }
+  start = Clock::now();
+  long succinct_checksum = 0;
+  for (int node : nodes) {
+    for (int child = succinct.first_child(node); child >= 0; child = succinct.next_sibling(child)) {
+      succinct_checksum++;
+    }
+    succinct_checksum += succinct.id(succinct.parent(node));
+  }
+  double succinct_seconds = seconds_since(start);
+  assert(succinct_checksum == checksum);
+  cout << "  SuccinctTree: " << succinct.bits_per_node() << " bits/node for the shape, "
+       << double(succinct.bytes()) / num_nodes << " bytes/node with labels, built in " << build_seconds
+       << " s; children + parent " << succinct_seconds / kQueries * 1e9 << " ns/query ("
+       << pointer_seconds / succinct_seconds << "x)\n";
+
+  // Every operation on every node, in preorder.
+  vector<int> all_nodes;
+  for (int i = 0; i < succinct.size(); i++) {
+    all_nodes.push_back(succinct.node(i));
+  }
+  struct Operation {
+    const char* name;
+    int (SuccinctTree::*run)(int) const;
+  };
+  for (Operation operation : {Operation{"parent", &SuccinctTree::parent},
+			      Operation{"first_child", &SuccinctTree::first_child},
+			      Operation{"next_sibling", &SuccinctTree::next_sibling},
+			      Operation{"subtree_size", &SuccinctTree::subtree_size},
+			      Operation{"depth", &SuccinctTree::depth}}) {
+    start = Clock::now();
+    long sum = 0;
+    for (int node : all_nodes) {
+      sum += (succinct.*operation.run)(node);
+    }
+    double elapsed = seconds_since(start);
+    cout << "    " << operation.name << ": " << elapsed / all_nodes.size() * 1e9 << " ns/node\n";
+    if (sum == 42) {
+      cout << "";
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  // Usage: ./bench [benchmark|all] [# vertices] [# edges]
+  string name = argc > 1 ? argv[1] : "all";
+  int num_vertices = argc > 2 ? std::atoi(argv[2]) : 100000;
+  size_t num_edges = argc > 3 ? std::atol(argv[3]) : 1000000;
+
+  if (name == "all" || name == "components") {
+    bench_components(num_vertices, num_edges);
+  }
+  if (name == "all" || name == "pagerank") {
+    bench_pagerank(num_vertices, num_edges);
+  }
+  if (name == "all" || name == "intersect") {
+    bench_intersect(num_vertices, num_edges);
+  }
+  if (name == "all" || name == "reorder") {
+    bench_reorder(num_vertices * 10);
+  }
+  if (name == "all" || name == "compressed") {
+    bench_compressed(num_vertices, num_edges);
+  }
+  if (name == "all" || name == "ingest") {
+    bench_ingest(num_vertices, num_edges);
+  }
+  if (name == "all" || name == "msbfs") {
+    bench_msbfs(num_vertices, num_edges);
+  }
+  if (name == "all" || name == "bloom") {
+    bench_adjacency_filter(num_vertices, num_edges);
+  }
+  if (name == "all" || name == "subgraph") {
+    bench_subgraph(num_vertices, num_edges);
+  }
+  if (name == "all" || name == "succinct") {
+    bench_succinct(num_vertices);
+  }
+}
@@ -0,0 +1,76 @@
+// A blocked Bloom filter over 64-bit keys: every key sets and tests all
+// of its bits inside a single 64-byte block, so a lookup touches one
+// cache line. Sized for a number of keys and a target false-positive
+// rate; past that capacity the rate degrades, and the owner is expected
+// to rebuild it bigger (see needs_rebuild()).
+class BloomFilter {
+ public:
+  BloomFilter() {}
+  BloomFilter(size_t capacity, double false_positive_rate) : capacity_(std::max<size_t>(capacity, 64)) {
+    // The textbook optimum: -ln(p) / ln(2)^2 bits and ln(2) * bits hashes
+    // per key. Confining keys to blocks costs a little accuracy on top.
+    double bits_per_key = -std::log(false_positive_rate) / (std::log(2.0) * std::log(2.0));
+    num_hashes_ = std::max(1, std::min(16, int(std::round(bits_per_key * std::log(2.0)))));
+    blocks_.resize(std::max<size_t>(1, size_t(bits_per_key * capacity_ / kBlockBits) + 1));
+  }
+
+  void insert(uint64_t key) {
+    uint64_t hash = mix64(key);
+    Block& block = blocks_[block_(hash)];
+    uint32_t h1 = uint32_t(hash), h2 = uint32_t(mix64(hash) | 1);
+    for (int i = 0; i < num_hashes_; i++) {
+      uint32_t bit = (h1 + i * h2) % kBlockBits;
+      block.words[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+    size_++;
+  }
+
+  // False means the key was definitely never inserted.
+  bool may_contain(uint64_t key) const {
+    if (blocks_.empty()) {
+      return false;
+    }
+    uint64_t hash = mix64(key);
+    const Block& block = blocks_[block_(hash)];
+    uint32_t h1 = uint32_t(hash), h2 = uint32_t(mix64(hash) | 1);
+    for (int i = 0; i < num_hashes_; i++) {
+      uint32_t bit = (h1 + i * h2) % kBlockBits;
+      if (!(block.words[bit / 64] & (uint64_t(1) << (bit % 64)))) {
+	return false;
+      }
+    }
+    return true;
+  }
+
+  // Starts loading the block of key, ahead of a may_contain(key).
+  void prefetch(uint64_t key) const {
+    if (!blocks_.empty()) {
+      __builtin_prefetch(&blocks_[block_(mix64(key))]);
+    }
+  }
+
+  bool needs_rebuild() const {
+    return size_ > capacity_;
+  }
+
+  size_t bytes() const {
+    return blocks_.size() * sizeof(Block);
+  }
+
+ private:
+  static constexpr uint32_t kBlockBits = 512;
+
+  struct alignas(64) Block {
+    uint64_t words[kBlockBits / 64] = {};
+  };
+
+  vector<Block> blocks_;
+  int num_hashes_ = 0;
+  size_t capacity_ = 0;
+  size_t size_ = 0;
+
+  // Maps the high half of the hash to a block without a division.
+  size_t block_(uint64_t hash) const {
+    return ((hash >> 32) * blocks_.size()) >> 32;
+  }
+};
@@ -0,0 +1,359 @@
+// Epoch-based reclamation. A reader pins the current epoch before it
+// dereferences shared state and unpins when done; a writer that unlinks
+// an object retires it, and the object is only deleted once every pinned
+// reader has moved past the epoch it was retired in. Pinning is two
+// stores and a load on the reader's own cache line: no locks, no shared
+// counters.
+//
+// Each thread gets a slot the first time it pins. Slots live in a list
+// that only grows, with a lock-free push, and a slot goes back to the
+// list when its thread exits, for the next new thread to reuse. So any
+// number of threads can read, and the list never holds many more slots
+// than the most threads alive at once.
+class EpochManager {
+ public:
+  static EpochManager& instance() {
+    static EpochManager manager;
+    return manager;
+  }
+
+  void pin() {
+    Registration& registration = registration_();
+    if (registration.depth++ == 0) {
+      registration.slot->epoch.store(epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+  }
+
+  void unpin() {
+    Registration& registration = registration_();
+    if (--registration.depth == 0) {
+      registration.slot->epoch.store(kIdle, std::memory_order_release);
+    }
+  }
+
+  // Deletes object once no reader can still see it. The caller must have
+  // unlinked it (so that new readers cannot reach it) before retiring.
+  template<typename T>
+  void retire(T* object) {
+    std::lock_guard<std::mutex> lock(retired_mutex_);
+    uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+    retired_.push_back(Retired{epoch, object, [](void* p) { delete static_cast<T*>(p); }});
+    collect_();
+  }
+
+  // Slots in the list, taken or not.
+  int slot_count() const {
+    int count = 0;
+    for (Slot* slot = slots_.load(std::memory_order_acquire); slot; slot = slot->next) {
+      count++;
+    }
+    return count;
+  }
+
+ private:
+  static constexpr uint64_t kIdle = ~uint64_t(0);
+
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> epoch{kIdle};
+    std::atomic<bool> taken{true};
+    // Set before the slot is published and never changed afterwards.
+    Slot* next = nullptr;
+  };
+
+  struct Retired {
+    uint64_t epoch;
+    void* object;
+    void (*deleter)(void*);
+  };
+
+  // A thread's claim on a slot, released when the thread exits.
+  struct Registration {
+    Slot* slot;
+    int depth = 0;
+    Registration() : slot(EpochManager::instance().claim_()) {}
+    ~Registration() {
+      slot->taken.store(false, std::memory_order_release);
+    }
+  };
+
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<Slot*> slots_{nullptr};
+  std::mutex retired_mutex_;
+  vector<Retired> retired_;
+
+  ~EpochManager() {
+    for (Retired& retired : retired_) {
+      retired.deleter(retired.object);
+    }
+    for (Slot* slot = slots_.load(); slot; ) {
+      Slot* next = slot->next;
+      delete slot;
+      slot = next;
+    }
+  }
+
+  Registration& registration_() {
+    thread_local Registration registration;
+    return registration;
+  }
+
+  // Reuses the slot of an exited thread, or pushes a new one.
+  Slot* claim_() {
+    for (Slot* slot = slots_.load(std::memory_order_acquire); slot; slot = slot->next) {
+      bool expected = false;
+      if (!slot->taken.load(std::memory_order_relaxed)
+	  && slot->taken.compare_exchange_strong(expected, true)) {
+	return slot;
+      }
+    }
+    Slot* slot = new Slot();
+    slot->next = slots_.load(std::memory_order_relaxed);
+    while (!slots_.compare_exchange_weak(slot->next, slot, std::memory_order_seq_cst)) {
+    }
+    return slot;
+  }
+
+  void collect_() {
+    uint64_t oldest = kIdle;
+    for (Slot* slot = slots_.load(std::memory_order_seq_cst); slot; slot = slot->next) {
+      oldest = std::min(oldest, slot->epoch.load(std::memory_order_seq_cst));
+    }
+    auto reclaimable = std::partition(retired_.begin(), retired_.end(), [&](const Retired& retired) {
+      return retired.epoch >= oldest;
+    });
+    for (auto it = reclaimable; it != retired_.end(); it++) {
+      it->deleter(it->object);
+    }
+    retired_.erase(reclaimable, retired_.end());
+  }
+};
+
+// A DirectedGraph that one writer can modify while any number of reader
+// threads query it. Readers work on a Snapshot: an immutable view of the
+// edges as they were when it was taken, which costs an epoch pin and two
+// atomic loads to take and never blocks on the writer. Vertex pointers
+// handed out by a snapshot stay valid for as long as the snapshot lives.
+// A snapshot must be destroyed on the thread that took it.
+//
+// Edges are appended to fixed-size chunks that never move, so adding an
+// edge only publishes a new size. When the chunk directory fills up, or
+// when edges are removed, the writer builds a new directory, publishes
+// it, and retires the old one to the EpochManager. Writers are
+// serialized with a mutex, which readers never touch.
+class ConcurrentDirectedGraph {
+ private:
+  static constexpr size_t kChunkSize = 1024;
+
+  // Edges live in vectors reserved to kChunkSize, so pushing into them
+  // never reallocates and readers can index them while they grow.
+  using Chunk = vector<Edge>;
+
+  struct Version {
+    vector<std::shared_ptr<Chunk>> chunks;
+    std::atomic<size_t> size{0};
+
+    const Edge& edge(size_t i) const {
+      return (*chunks[i / kChunkSize])[i % kChunkSize];
+    }
+  };
+
+ public:
+  class Snapshot {
+   public:
+    Snapshot(const Snapshot&) = delete;
+    Snapshot(Snapshot&& snapshot) : version_(snapshot.version_), size_(snapshot.size_) {
+      snapshot.version_ = nullptr;
+    }
+    ~Snapshot() {
+      if (version_) {
+	EpochManager::instance().unpin();
+      }
+    }
+
+    bool are_adjacent(const Vertex* u, const Vertex* v) const {
+      for (size_t i = 0; i < size_; i++) {
+	const Edge& e = version_->edge(i);
+	if (e.get_source().get() && *(e.get_source().get()) == *u) {
+	  if (e.get_dest().get() && *(e.get_dest().get()) == *v) {
+	    return true;
+	  }
+	}
+      }
+      return false;
+    }
+
+    int edge_count() const {
+      int num_edges = 0;
+      for (size_t i = 0; i < size_; i++) {
+	const Edge& e = version_->edge(i);
+	if (e.get_source() && e.get_dest()) {
+	  num_edges++;
+	}
+      }
+      return num_edges;
+    }
+
+    vector<Edge> get_adjacency_list() const {
+      vector<Edge> edges;
+      edges.reserve(size_);
+      for (size_t i = 0; i < size_; i++) {
+	edges.push_back(version_->edge(i));
+      }
+      return edges;
+    }
+
+    // The vertices are shared by every snapshot, hence const.
+    vector<const Vertex*> get_neighbors(const Vertex* vertex) const {
+      vector<const Vertex*> neighbors;
+      for (size_t i = 0; i < size_; i++) {
+	const Edge& e = version_->edge(i);
+	if (e.get_source().get() && *(e.get_source().get()) == *vertex) {
+	  if (e.get_dest().get()) {
+	    neighbors.push_back(e.get_dest().get());
+	  }
+	}
+      }
+      return neighbors;
+    }
+
+    const Vertex* top() const {
+      for (size_t i = 0; i < size_; i++) {
+	const Edge& e = version_->edge(i);
+	if (e.get_source().get()) {
+	  return e.get_source().get();
+	}
+      }
+      return nullptr;
+    }
+
+    int vertex_count() const {
+      std::set<int> vertex_ids;
+      for (size_t i = 0; i < size_; i++) {
+	const Edge& e = version_->edge(i);
+	if (e.get_source().get()) {
+	  vertex_ids.insert(e.get_source().get()->value().second);
+	}
+	if (e.get_dest().get()) {
+	  vertex_ids.insert(e.get_dest().get()->value().second);
+	}
+      }
+      return vertex_ids.size();
+    }
+
+    string to_string() const {
+      string str_value = "Graph (# vertices = " + std::to_string(vertex_count()) + "):\n";
+      for (size_t i = 0; i < size_; i++) {
+	str_value += version_->edge(i).to_string() + "\n";
+      }
+      return str_value;
+    }
+
+   private:
+    friend class ConcurrentDirectedGraph;
+
+    const Version* version_;
+    size_t size_;
+
+    Snapshot(const std::atomic<Version*>& current) {
+      EpochManager::instance().pin();
+      version_ = current.load(std::memory_order_seq_cst);
+      size_ = version_->size.load(std::memory_order_acquire);
+    }
+  };
+
+  ConcurrentDirectedGraph() {
+    current_.store(new Version());
+  }
+  ConcurrentDirectedGraph(const ConcurrentDirectedGraph&) = delete;
+  // No snapshot may outlive the graph.
+  ~ConcurrentDirectedGraph() {
+    delete current_.load();
+  }
+
+  Snapshot snapshot() const {
+    return Snapshot(current_);
+  }
+
+  bool add(const Vertex* v) {
+    Edge edge;
+    edge.set_source(*v);
+    append_(std::move(edge));
+    return true;
+  }
+
+  bool add_edge(const Vertex* u, const Vertex* v) {
+    Edge edge;
+    edge.set_source(*u);
+    edge.set_dest(*v);
+    append_(std::move(edge));
+    return true;
+  }
+
+  bool add_edge(const Edge* e) {
+    append_(Edge(*e));
+    return true;
+  }
+
+  bool remove_edge(const Edge* e) {
+    rebuild_([&](const Edge& edge) { return edge == *e; });
+    return true;
+  }
+
+  void remove(const Vertex* v) {
+    rebuild_([&](const Edge& edge) {
+      return edge.get_source().get() && *(edge.get_source().get()) == *v;
+    });
+  }
+
+ private:
+  std::atomic<Version*> current_;
+  std::mutex writer_mutex_;
+
+  void append_(Edge&& edge) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    Version* version = current_.load(std::memory_order_relaxed);
+    size_t size = version->size.load(std::memory_order_relaxed);
+    if (size == version->chunks.size() * kChunkSize) {
+      // Out of room: publish a directory with one more chunk. The chunks
+      // themselves are shared with the old directory, not copied.
+      Version* grown = new Version();
+      grown->chunks = version->chunks;
+      grown->chunks.push_back(std::make_shared<Chunk>());
+      grown->chunks.back()->reserve(kChunkSize);
+      grown->size.store(size, std::memory_order_relaxed);
+      publish_(grown);
+      version = grown;
+    }
+    version->chunks[size / kChunkSize]->push_back(std::move(edge));
+    version->size.store(size + 1, std::memory_order_release);
+  }
+
+  // Publishes a copy of the edges without those matching removed.
+  template<typename F>
+  void rebuild_(F removed) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    Version* version = current_.load(std::memory_order_relaxed);
+    size_t size = version->size.load(std::memory_order_relaxed);
+    Version* rebuilt = new Version();
+    size_t kept = 0;
+    for (size_t i = 0; i < size; i++) {
+      const Edge& edge = version->edge(i);
+      if (removed(edge)) {
+	continue;
+      }
+      if (kept % kChunkSize == 0) {
+	rebuilt->chunks.push_back(std::make_shared<Chunk>());
+	rebuilt->chunks.back()->reserve(kChunkSize);
+      }
+      rebuilt->chunks.back()->push_back(edge);
+      kept++;
+    }
+    rebuilt->size.store(kept, std::memory_order_relaxed);
+    publish_(rebuilt);
+  }
+
+  void publish_(Version* version) {
+    Version* old = current_.exchange(version, std::memory_order_seq_cst);
+    EpochManager::instance().retire(old);
+  }
+};
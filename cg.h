@@ -0,0 +1,232 @@
+// Per-vertex adjacency in compressed-sparse-row form: the neighbors of
+// dense index v are targets[offsets[v] .. offsets[v + 1]).
+struct Adjacency {
+  vector<size_t> offsets;
+  vector<int> targets;
+
+  int degree(int v) const {
+    return offsets[v + 1] - offsets[v];
+  }
+  const int* begin(int v) const {
+    return targets.data() + offsets[v];
+  }
+  const int* end(int v) const {
+    return targets.data() + offsets[v + 1];
+  }
+
+  // Buckets the pairs (keys[i], values[i]) by key with a counting sort;
+  // each bucket keeps the pairs in their original order.
+  static Adjacency from_pairs(int num_vertices, const vector<int>& keys, const vector<int>& values) {
+    Adjacency adjacency;
+    adjacency.offsets.assign(num_vertices + 1, 0);
+    for (int key : keys) {
+      adjacency.offsets[key + 1]++;
+    }
+    for (int v = 0; v < num_vertices; v++) {
+      adjacency.offsets[v + 1] += adjacency.offsets[v];
+    }
+    adjacency.targets.resize(keys.size());
+    vector<size_t> next(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    for (size_t e = 0; e < keys.size(); e++) {
+      adjacency.targets[next[keys[e]]++] = values[e];
+    }
+    return adjacency;
+  }
+
+  // Sorts every neighbor list and drops duplicate neighbors, so that the
+  // lists can be intersected.
+  void sort_unique() {
+    size_t write = 0;
+    for (size_t v = 0; v + 1 < offsets.size(); v++) {
+      auto begin = targets.begin() + offsets[v];
+      auto end = targets.begin() + offsets[v + 1];
+      std::sort(begin, end);
+      end = std::unique(begin, end);
+      offsets[v] = write;
+      write = std::copy(begin, end, targets.begin() + write) - targets.begin();
+    }
+    offsets.back() = write;
+    targets.resize(write);
+  }
+};
+
+// A read-only, index-based view of a graph's edges. Every vertex id
+// (the second part of its Value) is renumbered to a dense index in
+// [0, vertex_count()) in order of first appearance (or in the order given
+// to relabel()), so the analytics in graph_lib can run over flat int
+// arrays instead of Edge objects.
+class CompactGraph {
+ public:
+  CompactGraph(const vector<Edge>& edges) {
+    for (const Edge& e : edges) {
+      int source = -1;
+      if (e.get_source().get()) {
+	source = intern_(e.get_source().get()->value().second);
+      }
+      if (e.get_dest().get()) {
+	int dest = intern_(e.get_dest().get()->value().second);
+	// An Edge is only a "true" edge if it has both ends.
+	if (source >= 0) {
+	  sources_.push_back(source);
+	  dests_.push_back(dest);
+	}
+      }
+    }
+  }
+
+  int vertex_count() const {
+    return ids_.size();
+  }
+
+  size_t edge_count() const {
+    return sources_.size();
+  }
+
+  // Maps a dense index back to the vertex id it was built from.
+  int id(int index) const {
+    return ids_[index];
+  }
+
+  // Maps a vertex id to its dense index, or -1 if it is not in the graph.
+  int index(int id) const {
+    auto it = indices_.find(id);
+    return it == indices_.end() ? -1 : it->second;
+  }
+
+  int source(size_t edge) const {
+    return sources_[edge];
+  }
+
+  int dest(size_t edge) const {
+    return dests_[edge];
+  }
+
+  // Successors of every vertex, in edge-list order.
+  Adjacency out_edges() const {
+    return Adjacency::from_pairs(vertex_count(), sources_, dests_);
+  }
+
+  // Predecessors of every vertex, in edge-list order.
+  Adjacency in_edges() const {
+    return Adjacency::from_pairs(vertex_count(), dests_, sources_);
+  }
+
+  // Neighbors of every vertex in either direction, as if each edge were
+  // undirected.
+  Adjacency undirected_edges() const {
+    vector<int> keys(sources_);
+    keys.insert(keys.end(), dests_.begin(), dests_.end());
+    vector<int> values(dests_);
+    values.insert(values.end(), sources_.begin(), sources_.end());
+    return Adjacency::from_pairs(vertex_count(), keys, values);
+  }
+
+  // Renumbers the dense indices so that order[i] becomes index i; order
+  // must be a permutation of [0, vertex_count()). Vertex ids, and so the
+  // mapping to the graph's Values, are unchanged.
+  void relabel(const vector<int>& order) {
+    vector<int> rank(order.size());
+    vector<int> ids(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+      rank[order[i]] = i;
+      ids[i] = ids_[order[i]];
+      indices_[ids[i]] = i;
+    }
+    ids_.swap(ids);
+    for (size_t e = 0; e < sources_.size(); e++) {
+      sources_[e] = rank[sources_[e]];
+      dests_[e] = rank[dests_[e]];
+    }
+  }
+
+  // Successors of every vertex, sorted by index and without duplicates.
+  Adjacency sorted_out_edges() const {
+    Adjacency adjacency = out_edges();
+    adjacency.sort_unique();
+    return adjacency;
+  }
+
+ private:
+  vector<int> ids_;
+  std::unordered_map<int, int> indices_;
+  vector<int> sources_;
+  vector<int> dests_;
+
+  int intern_(int id) {
+    auto inserted = indices_.insert(std::pair<int, int>(id, ids_.size()));
+    if (inserted.second) {
+      ids_.push_back(id);
+    }
+    return inserted.first->second;
+  }
+};
+
+// Holds threads until num_threads of them have called wait(). The last to
+// arrive first runs completion, alone, and then releases all of them, so
+// completion can do the serial work between two parallel phases.
+class Barrier {
+ public:
+  Barrier(int num_threads) : num_threads_(num_threads) {}
+
+  template<typename F>
+  void wait(F completion) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    long generation = generation_;
+    if (++arrived_ == num_threads_) {
+      completion();
+      arrived_ = 0;
+      generation_++;
+      released_.notify_all();
+      return;
+    }
+    released_.wait(lock, [&]() { return generation_ != generation; });
+  }
+
+  void wait() {
+    wait([]() {});
+  }
+
+ private:
+  int num_threads_;
+  int arrived_ = 0;
+  long generation_ = 0;
+  std::mutex mutex_;
+  std::condition_variable released_;
+};
+
+namespace graph_lib {
+  // Number of worker threads to use when the caller asks for "0" (the
+  // default): one per hardware thread.
+  int thread_count(int requested) {
+    if (requested > 0) {
+      return requested;
+    }
+    int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+  }
+
+  // Splits [0, n) into num_threads contiguous ranges and calls
+  // fn(begin, end, thread) for each of them on its own thread.
+  template<typename F>
+  void parallel_for(size_t n, int num_threads, F fn) {
+    num_threads = thread_count(num_threads);
+    if (num_threads == 1 || n < 2) {
+      fn(size_t(0), n, 0);
+      return;
+    }
+    vector<std::thread> workers;
+    size_t chunk = (n + num_threads - 1) / num_threads;
+    for (int t = 0; t < num_threads; t++) {
+      size_t begin = std::min(n, t * chunk);
+      size_t end = std::min(n, begin + chunk);
+      workers.emplace_back(fn, begin, end, t);
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+
+  CompactGraph compact(Graph<Vertex*, Edge*>& g) {
+    return CompactGraph(g.edges());
+  }
+}
@@ -0,0 +1,95 @@
+// Union-find over dense vertex indices that tolerates concurrent
+// unite() calls. Roots are always linked from the larger index to the
+// smaller one, so a successful CAS can never close a cycle, and find()
+// compresses paths by halving with CAS; losing a race only means the
+// path stays a little longer.
+class ConcurrentUnionFind {
+ public:
+  ConcurrentUnionFind(int size) : parent_(size) {
+    for (int i = 0; i < size; i++) {
+      parent_[i].store(i, std::memory_order_relaxed);
+    }
+  }
+
+  int find(int x) {
+    while (true) {
+      int parent = parent_[x].load(std::memory_order_relaxed);
+      if (parent == x) {
+	return x;
+      }
+      int grandparent = parent_[parent].load(std::memory_order_relaxed);
+      if (parent != grandparent) {
+	parent_[x].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+      }
+      x = grandparent;
+    }
+  }
+
+  void unite(int x, int y) {
+    while (true) {
+      x = find(x);
+      y = find(y);
+      if (x == y) {
+	return;
+      }
+      if (x < y) {
+	std::swap(x, y);
+      }
+      // x is the larger root: hang it under y, unless someone else got
+      // to x first, in which case start over from the new roots.
+      int expected = x;
+      if (parent_[x].compare_exchange_strong(expected, y, std::memory_order_relaxed)) {
+	return;
+      }
+    }
+  }
+
+ private:
+  vector<std::atomic<int>> parent_;
+};
+
+namespace graph_lib {
+  // Weakly-connected components (edge direction is ignored) of a
+  // compacted graph, as one label per dense index. The label is the
+  // smallest dense index in the component, i.e. the vertex of the
+  // component that appears first in the edge list.
+  vector<int> component_labels(const CompactGraph& cg, int num_threads = 0) {
+    ConcurrentUnionFind union_find(cg.vertex_count());
+    parallel_for(cg.edge_count(), num_threads, [&](size_t begin, size_t end, int) {
+      for (size_t e = begin; e < end; e++) {
+	union_find.unite(cg.source(e), cg.dest(e));
+      }
+    });
+    vector<int> labels(cg.vertex_count());
+    parallel_for(labels.size(), num_threads, [&](size_t begin, size_t end, int) {
+      for (size_t v = begin; v < end; v++) {
+	labels[v] = union_find.find(v);
+      }
+    });
+    return labels;
+  }
+
+  // Maps every vertex id in g to the id of the representative vertex of
+  // its weakly-connected component.
+  std::map<int, int> connected_components(Graph<Vertex*, Edge*>& g, int num_threads = 0) {
+    CompactGraph cg = compact(g);
+    vector<int> labels = component_labels(cg, num_threads);
+    std::map<int, int> components;
+    for (int v = 0; v < cg.vertex_count(); v++) {
+      components.insert(std::pair<int, int>(cg.id(v), cg.id(labels[v])));
+    }
+    return components;
+  }
+
+  int count_components(Graph<Vertex*, Edge*>& g, int num_threads = 0) {
+    CompactGraph cg = compact(g);
+    vector<int> labels = component_labels(cg, num_threads);
+    int num_components = 0;
+    for (int v = 0; v < cg.vertex_count(); v++) {
+      if (labels[v] == v) {
+	num_components++;
+      }
+    }
+    return num_components;
+  }
+}
@@ -0,0 +1,218 @@
+// Longest-path analytics for a DAG, kept up to date as edges come and
+// go. The depth of a vertex is the length of the longest path reaching it
+// from a vertex without predecessors, its height the length of the
+// longest path from it to a vertex without successors, and the critical
+// path is a longest path of the whole graph. Lengths add up edge weights
+// (see weight()); vertices without edges have depth and height 0.
+//
+// Adding or removing an edge u -> v only marks v's depth and u's height
+// as stale. The next query recomputes stale vertices from their direct
+// neighbors and, only where a value actually changed, marks the vertices
+// downstream (depth) or upstream (height) as stale in turn. The critical
+// length is cached along with the vertices without predecessors, and is
+// only recomputed after a height or the set of such vertices changed, so
+// length() and on_critical_path() are O(1) between updates.
+class CriticalPath {
+ public:
+  // The int part of an edge's Value; edges added without a value (i.e.
+  // with kDummyValue) weigh 1.
+  static int weight(const Edge& e) {
+    if (!e.value() || *e.value() == kDummyValue) {
+      return 1;
+    }
+    return e.value()->second;
+  }
+
+  void add_vertex(int id) {
+    node_(id);
+  }
+
+  void add_edge(int source, int dest, int weight) {
+    node_(source).successors.push_back(std::pair<int, int>(dest, weight));
+    Node& node = node_(dest);
+    node.predecessors.push_back(std::pair<int, int>(source, weight));
+    if (node.predecessors.size() == 1) {
+      starts_.erase(dest);
+      length_stale_ = true;
+    }
+    stale_depths_.push_back(dest);
+    stale_heights_.push_back(source);
+  }
+
+  // Removes count copies of the edge source -> dest with this weight.
+  void remove_edge(int source, int dest, int weight, int count = 1) {
+    erase_(node_(source).successors, std::pair<int, int>(dest, weight), count);
+    erase_predecessor_(dest, std::pair<int, int>(source, weight), count);
+    stale_depths_.push_back(dest);
+    stale_heights_.push_back(source);
+  }
+
+  // Removes every edge out of id.
+  void remove_successors(int id) {
+    Node& node = node_(id);
+    for (auto& successor : node.successors) {
+      erase_predecessor_(successor.first, std::pair<int, int>(id, successor.second), 1);
+      stale_depths_.push_back(successor.first);
+    }
+    node.successors.clear();
+    stale_heights_.push_back(id);
+  }
+
+  int depth(int id) {
+    update_();
+    auto it = nodes_.find(id);
+    return it == nodes_.end() ? 0 : it->second.depth;
+  }
+
+  int height(int id) {
+    update_();
+    auto it = nodes_.find(id);
+    return it == nodes_.end() ? 0 : it->second.height;
+  }
+
+  int length() {
+    update_();
+    if (length_stale_) {
+      // Paths start at vertices without predecessors, which only matters
+      // for negative weights.
+      length_ = 0;
+      for (int id : starts_) {
+	length_ = std::max(length_, nodes_[id].height);
+      }
+      length_stale_ = false;
+    }
+    return length_;
+  }
+
+  bool on_critical_path(int id) {
+    update_();
+    auto it = nodes_.find(id);
+    return it != nodes_.end() && it->second.depth + it->second.height == length();
+  }
+
+  // The ids along one longest path, from its start to its end; empty if
+  // the graph has no edges.
+  vector<int> path() {
+    int critical_length = length();
+    vector<int> path;
+    for (int id : starts_) {
+      const Node& node = nodes_[id];
+      if (!node.successors.empty() && node.height == critical_length) {
+	path.push_back(id);
+	break;
+      }
+    }
+    while (!path.empty()) {
+      const Node& node = nodes_[path.back()];
+      int next = -1;
+      for (auto& successor : node.successors) {
+	if (successor.second + nodes_[successor.first].height == node.height) {
+	  next = successor.first;
+	  break;
+	}
+      }
+      if (next < 0) {
+	break;
+      }
+      path.push_back(next);
+    }
+    return path;
+  }
+
+ private:
+  struct Node {
+    // (neighbor id, weight), one entry per edge.
+    vector<std::pair<int, int>> successors;
+    vector<std::pair<int, int>> predecessors;
+    int depth = 0;
+    int height = 0;
+  };
+
+  std::unordered_map<int, Node> nodes_;
+  vector<int> stale_depths_;
+  vector<int> stale_heights_;
+  // Vertices without predecessors, and the longest height among them.
+  std::unordered_set<int> starts_;
+  int length_ = 0;
+  bool length_stale_ = false;
+
+  Node& node_(int id) {
+    auto inserted = nodes_.insert(std::pair<int, Node>(id, Node()));
+    if (inserted.second) {
+      starts_.insert(id);
+    }
+    return inserted.first->second;
+  }
+
+  void erase_predecessor_(int id, const std::pair<int, int>& edge, int count) {
+    Node& node = node_(id);
+    if (!node.predecessors.empty()) {
+      erase_(node.predecessors, edge, count);
+      if (node.predecessors.empty()) {
+	starts_.insert(id);
+	length_stale_ = true;
+      }
+    }
+  }
+
+  static void erase_(vector<std::pair<int, int>>& edges, const std::pair<int, int>& edge, int count) {
+    for (auto it = edges.begin(); it != edges.end() && count > 0; ) {
+      if (*it == edge) {
+	it = edges.erase(it);
+	count--;
+      } else {
+	it++;
+      }
+    }
+  }
+
+  void update_() {
+    propagate_(stale_depths_, &Node::predecessors, &Node::successors, &Node::depth);
+    if (propagate_(stale_heights_, &Node::successors, &Node::predecessors, &Node::height)) {
+      length_stale_ = true;
+    }
+  }
+
+  // Recomputes value for every stale vertex as the max of (value of
+  // neighbor + weight) over its inputs, and marks its outputs stale
+  // whenever it changes. Terminates because the graph is acyclic. Returns
+  // whether any value changed.
+  bool propagate_(vector<int>& stale, vector<std::pair<int, int>> Node::*inputs,
+		  vector<std::pair<int, int>> Node::*outputs, int Node::*value) {
+    // A vertex touched by many edges is stale many times over, but is
+    // only recomputed once.
+    std::deque<int> queue;
+    std::unordered_set<int> queued;
+    for (int id : stale) {
+      if (queued.insert(id).second) {
+	queue.push_back(id);
+      }
+    }
+    stale.clear();
+    bool changed = false;
+    while (!queue.empty()) {
+      int id = queue.front();
+      queue.pop_front();
+      queued.erase(id);
+      Node& node = nodes_[id];
+      int updated = 0;
+      bool first = true;
+      for (auto& input : node.*inputs) {
+	int candidate = nodes_[input.first].*value + input.second;
+	updated = first ? candidate : std::max(updated, candidate);
+	first = false;
+      }
+      if (updated == node.*value) {
+	continue;
+      }
+      node.*value = updated;
+      changed = true;
+      for (auto& output : node.*outputs) {
+	if (queued.insert(output.first).second) {
+	  queue.push_back(output.first);
+	}
+      }
+    }
+    return changed;
+  }
+};
@@ -3,37 +3,94 @@ class DirectedAcyclicGraph {
   DirectedAcyclicGraph() {
     directed_graph_ = std::make_unique<DirectedGraph>();
   }
+  // See DirectedGraph(bool simple).
+  DirectedAcyclicGraph(bool simple) {
+    directed_graph_ = std::make_unique<DirectedGraph>(simple);
+  }
   DirectedAcyclicGraph(const DirectedAcyclicGraph& dag) noexcept {
     if (dag.directed_graph_.get()) {
       directed_graph_ = std::make_unique<DirectedGraph>(*(dag.directed_graph_.get()));
     }
+    critical_path_ = dag.critical_path_;
+  }
+  bool is_simple() const {
+    return directed_graph_.get()->is_simple();
   }
   bool add(const Vertex* u) {
-    return directed_graph_.get()->add(u);
+    if (!directed_graph_.get()->add(u)) {
+      return false;
+    }
+    critical_path_.add_vertex(u->value().second);
+    return true;
   }
   bool add_edge(const Vertex* source, const Vertex* dest) {
-    directed_graph_.get()->add_edge(source, dest);
+    if (!directed_graph_.get()->add_edge(source, dest)) {
+      return false;
+    }
     if (check_for_cycles_()) {
       Edge edge(std::make_unique<Vertex>(*source), std::make_unique<Vertex>(*dest), std::make_unique<Value>(kDummyValue));
       directed_graph_.get()->remove_edge(&edge);
       return false;
     }
+    critical_path_.add_edge(source->value().second, dest->value().second, 1);
     return true;
   }
   bool add_edge(const Edge* edge) {
-    directed_graph_.get()->add_edge(edge);
+    if (!directed_graph_.get()->add_edge(edge)) {
+      return false;
+    }
     if (check_for_cycles_()) {
       directed_graph_.get()->remove_edge(edge);
       return false;
     }
+    if (edge->get_source() && edge->get_dest()) {
+      critical_path_.add_edge(edge->get_source()->value().second, edge->get_dest()->value().second,
+			      CriticalPath::weight(*edge));
+    }
+    return true;
+  }
+  // Appends the batches without checking for cycles: only for edges that
+  // are known to keep the graph acyclic, such as the edges of a subgraph
+  // of another DAG.
+  void append_edges(vector<vector<Edge>>& batches) {
+    size_t first = edges().size();
+    directed_graph_.get()->append_edges(batches);
+    for (size_t i = first; i < edges().size(); i++) {
+      const Edge& edge = edges()[i];
+      if (edge.get_source() && edge.get_dest()) {
+	critical_path_.add_edge(edge.get_source()->value().second, edge.get_dest()->value().second,
+				CriticalPath::weight(edge));
+      } else if (edge.get_source()) {
+	critical_path_.add_vertex(edge.get_source()->value().second);
+      }
+    }
+  }
+  bool remove_edge(const Edge* edge) {
+    size_t size = edges().size();
+    directed_graph_.get()->remove_edge(edge);
+    int removed = size - edges().size();
+    if (removed > 0 && edge->get_source() && edge->get_dest()) {
+      critical_path_.remove_edge(edge->get_source()->value().second, edge->get_dest()->value().second,
+				 CriticalPath::weight(*edge), removed);
+    }
     return true;
   }
   vector<Edge> get_adjacency_list() {
     return directed_graph_.get()->get_adjacency_list();
   }
+  const vector<Edge>& edges() const {
+    return directed_graph_.get()->edges();
+  }
+  // See DirectedGraph::set_adjacency_filter.
+  void set_adjacency_filter(double false_positive_rate) {
+    directed_graph_.get()->set_adjacency_filter(false_positive_rate);
+  }
   bool are_adjacent(const Vertex* u, const Vertex* v) {
     return directed_graph_.get()->are_adjacent(u, v);
   }
+  vector<bool> are_adjacent(const vector<std::pair<const Vertex*, const Vertex*>>& pairs) {
+    return directed_graph_.get()->are_adjacent(pairs);
+  }
   int edge_count() {
     return directed_graph_.get()->edge_count();
   }
@@ -42,6 +99,7 @@ class DirectedAcyclicGraph {
   }
   void remove(const Vertex* u) {
     directed_graph_.get()->remove(u);
+    critical_path_.remove_successors(u->value().second);
   }
   Vertex* top() {
     return directed_graph_.get()->top();
@@ -52,8 +110,27 @@ class DirectedAcyclicGraph {
   string to_string() {
     return directed_graph_.get()->to_string();
   } 
+
+  // Longest paths, weighted by CriticalPath::weight(); see critical.h.
+  int depth(const Vertex* u) {
+    return critical_path_.depth(u->value().second);
+  }
+  int height(const Vertex* u) {
+    return critical_path_.height(u->value().second);
+  }
+  int critical_path_length() {
+    return critical_path_.length();
+  }
+  bool on_critical_path(const Vertex* u) {
+    return critical_path_.on_critical_path(u->value().second);
+  }
+  // Vertex ids along a critical path, from start to end.
+  vector<int> critical_path() {
+    return critical_path_.path();
+  }
  private:
   unique_ptr<DirectedGraph> directed_graph_;
+  CriticalPath critical_path_;
 
   bool check_for_cycles_() {
     // Based on http://www.geeksforgeeks.org/detect-cycle-in-a-graph/.
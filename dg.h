@@ -1,6 +1,21 @@
 class DirectedGraph {
  public:
+  DirectedGraph() {}
+  // In a simple graph, vertices are identified by their id (the second
+  // part of their Value), each vertex is recorded once and there is at
+  // most one edge from a vertex to another: add and add_edge return false
+  // instead of storing a duplicate, checked in O(1) against hash sets of
+  // vertex ids and (source, dest) id pairs.
+  DirectedGraph(bool simple) : simple_(simple) {}
+
+  bool is_simple() const {
+    return simple_;
+  }
+
   bool add(const Vertex* v) {
+    if (simple_ && !vertex_ids_.insert(IdSet::vertex_key(v->value().second))) {
+      return false;
+    }
     Edge edge;
     edge.set_source(*v);
     edges_.push_back(edge);
@@ -8,24 +23,80 @@ class DirectedGraph {
   } 
 
   bool add_edge(const Vertex* u, const Vertex* v) {
+    if (simple_ && !record_edge_(u->value().second, v->value().second)) {
+      return false;
+    }
     Edge edge;
     edge.set_source(*u);
     edge.set_dest(*v);
     edges_.push_back(edge);
+    filter_edge_(edges_.back());
     return true;
   }
 
   bool add_edge(const Edge* e) {
+    if (simple_ && !record_(*e)) {
+      return false;
+    }
     edges_.push_back(*e);
+    filter_edge_(edges_.back());
     return true;
   }
 
+  // Moves every batch, in order, to the end of the edge list, and leaves
+  // the batches empty. A simple graph skips the duplicates.
+  void append_edges(vector<vector<Edge>>& batches) {
+    size_t size = edges_.size();
+    for (const vector<Edge>& batch : batches) {
+      size += batch.size();
+    }
+    edges_.reserve(size);
+    size_t first = edges_.size();
+    for (vector<Edge>& batch : batches) {
+      if (simple_) {
+	for (Edge& e : batch) {
+	  if (record_(e)) {
+	    edges_.push_back(std::move(e));
+	  }
+	}
+      } else {
+	std::move(batch.begin(), batch.end(), std::back_inserter(edges_));
+      }
+      batch.clear();
+    }
+    for (size_t i = first; i < edges_.size(); i++) {
+      filter_edge_(edges_[i]);
+    }
+  }
+
   bool remove_edge(const Edge* e) {
     edges_.erase(std::remove(edges_.begin(), edges_.end(), *e), edges_.end());
+    rebuild_ids_();
+    filter_stale_ = true;
     return true;
   }
 
+  // Keeps a blocked Bloom filter of the (source id, dest id) pairs of the
+  // edges, so that are_adjacent answers most "no"s from one cache line
+  // instead of a scan. The filter is kept up to date as edges are added
+  // and rebuilt on the next query after a removal, or once the graph
+  // outgrows it. A rate of 0 turns it off.
+  void set_adjacency_filter(double false_positive_rate) {
+    filter_rate_ = false_positive_rate;
+    filter_ = BloomFilter();
+    filter_stale_ = true;
+  }
+
   bool are_adjacent(const Vertex* u, const Vertex* v) {
+    if (filter_rate_ > 0) {
+      refresh_filter_();
+      if (!filter_.may_contain(IdSet::pair_key(u->value().second, v->value().second))) {
+	return false;
+      }
+    }
+    if (simple_) {
+      return edge_ids_.contains(IdSet::pair_key(u->value().second, v->value().second));
+    }
     for (const Edge& e : edges_) {
       if (e.get_source().get() && *(e.get_source().get()) == *u) {
 	if (e.get_dest().get() && *(e.get_dest().get()) == *v) {
@@ -36,6 +107,57 @@ class DirectedGraph {
     return false;
   }
 
+  // are_adjacent for many pairs at once. The Bloom filter (if any) is
+  // probed a few pairs ahead of a prefetch, and the pairs that pass it
+  // are then checked together in a single scan of the edges.
+  vector<bool> are_adjacent(const vector<std::pair<const Vertex*, const Vertex*>>& pairs) {
+    const size_t kPrefetchDistance = 8;
+    vector<bool> adjacent(pairs.size());
+    vector<uint64_t> keys;
+    for (auto& pair : pairs) {
+      keys.push_back(IdSet::pair_key(pair.first->value().second, pair.second->value().second));
+    }
+    std::unordered_map<uint64_t, vector<size_t>> candidates;
+    if (filter_rate_ > 0) {
+      refresh_filter_();
+    }
+    for (size_t i = 0; i < pairs.size(); i++) {
+      if (filter_rate_ > 0) {
+	if (i + kPrefetchDistance < pairs.size()) {
+	  filter_.prefetch(keys[i + kPrefetchDistance]);
+	}
+	if (!filter_.may_contain(keys[i])) {
+	  continue;
+	}
+      }
+      if (simple_) {
+	adjacent[i] = edge_ids_.contains(keys[i]);
+      } else {
+	candidates[keys[i]].push_back(i);
+      }
+    }
+    if (candidates.empty()) {
+      return adjacent;
+    }
+    for (const Edge& e : edges_) {
+      if (!e.get_source() || !e.get_dest()) {
+	continue;
+      }
+      const Vertex& source = *e.get_source();
+      const Vertex& dest = *e.get_dest();
+      auto it = candidates.find(IdSet::pair_key(source.value().second, dest.value().second));
+      if (it == candidates.end()) {
+	continue;
+      }
+      for (size_t i : it->second) {
+	if (source == *pairs[i].first && dest == *pairs[i].second) {
+	  adjacent[i] = true;
+	}
+      }
+    }
+    return adjacent;
+  }
+
   int edge_count() const {
     int num_edges = 0;
     for (const Edge& e : edges_) {
@@ -52,6 +174,10 @@ class DirectedGraph {
     return edges_;
   }
 
+  const vector<Edge>& edges() const {
+    return edges_;
+  }
+
   vector<Vertex*> get_neighbors(Vertex* vertex) {
     vector<Vertex*> neighbors;
     for (const Edge& e : edges_) {
@@ -65,16 +191,13 @@ class DirectedGraph {
   }
 
   void remove(const Vertex* v) {
-    for (Edge& e : edges_) {
-      if (e.get_source().get() && *(e.get_source().get()) == *v) {
-	// Remove the edge: if the source is gone, the edge to the dest
-	// is no longer needed.
-	auto it = std::find(edges_.begin(), edges_.end(), e);
-	if (it != edges_.end()) {
-	  edges_.erase(it);
-	}
-      }
-    }
+    // Remove the edges out of v: if the source is gone, the edge to the
+    // dest is no longer needed.
+    edges_.erase(std::remove_if(edges_.begin(), edges_.end(), [&](const Edge& e) {
+      return e.get_source().get() && *(e.get_source().get()) == *v;
+    }), edges_.end());
+    rebuild_ids_();
+    filter_stale_ = true;
   }
 
   string to_string() const {
@@ -95,6 +218,9 @@ class DirectedGraph {
   }
   
   int vertex_count() const {
+    if (simple_) {
+      return vertex_ids_.size();
+    }
     std::set<int> vertex_ids;
     for (const Edge& e : edges_) {
       if (e.get_source().get()) {
@@ -110,4 +236,61 @@ class DirectedGraph {
 
  private:
   vector<Edge> edges_;
+  bool simple_ = false;
+  IdSet vertex_ids_;
+  IdSet edge_ids_;
+  double filter_rate_ = 0;
+  BloomFilter filter_;
+  bool filter_stale_ = false;
+
+  // Records the ids of a new edge; false if it is already in the graph.
+  bool record_edge_(int source, int dest) {
+    if (!edge_ids_.insert(IdSet::pair_key(source, dest))) {
+      return false;
+    }
+    vertex_ids_.insert(IdSet::vertex_key(source));
+    vertex_ids_.insert(IdSet::vertex_key(dest));
+    return true;
+  }
+
+  bool record_(const Edge& e) {
+    const Vertex* source = e.get_source().get();
+    const Vertex* dest = e.get_dest().get();
+    if (source && dest) {
+      return record_edge_(source->value().second, dest->value().second);
+    }
+    const Vertex* v = source ? source : dest;
+    return !v || vertex_ids_.insert(IdSet::vertex_key(v->value().second));
+  }
+
+  void filter_edge_(const Edge& e) {
+    if (filter_rate_ > 0 && !filter_stale_ && e.get_source() && e.get_dest()) {
+      filter_.insert(IdSet::pair_key(e.get_source()->value().second, e.get_dest()->value().second));
+      filter_stale_ = filter_.needs_rebuild();
+    }
+  }
+
+  void refresh_filter_() {
+    if (!filter_stale_) {
+      return;
+    }
+    // Leave room to grow before the next rebuild.
+    filter_ = BloomFilter(2 * edges_.size(), filter_rate_);
+    filter_stale_ = false;
+    for (const Edge& e : edges_) {
+      filter_edge_(e);
+    }
+  }
+
+  // After a removal, some ids may no longer be in the graph.
+  void rebuild_ids_() {
+    if (!simple_) {
+      return;
+    }
+    vertex_ids_.clear();
+    edge_ids_.clear();
+    for (const Edge& e : edges_) {
+      record_(e);
+    }
+  }
 };
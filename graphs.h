@@ -1,10 +1,21 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <stack>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 using std::ostringstream; 
@@ -143,6 +154,9 @@ class Vertex {
   Value& value() {
     return value_;
   }
+  const Value& value() const {
+    return value_;
+  }
   void set_value(Value& value) {
     value_ = value;
   }
@@ -230,6 +244,10 @@ class Edge {
     return value_.get();
   }
 
+  const Value* value() const {
+    return value_.get();
+  }
+
   void set_value(Value& value) {
     value_ = std::make_unique<Value>(value);
   }
@@ -239,3 +257,30 @@ class Edge {
   unique_ptr<Vertex> dest_;
   unique_ptr<Value> value_ = std::make_unique<Value>(kDummyValue);
 };
+
+// Hashing, consistent with the operator== of each type.
+struct ValueHash {
+  size_t operator()(const Value& value) const {
+    return std::hash<string>()(value.first) * 31 + std::hash<int>()(value.second);
+  }
+};
+
+namespace std {
+  template<>
+  struct hash<Vertex> {
+    size_t operator()(const Vertex& vertex) const {
+      return ValueHash()(vertex.value());
+    }
+  };
+
+  template<>
+  struct hash<Edge> {
+    size_t operator()(const Edge& edge) const {
+      size_t h = 0;
+      for (const Vertex* v : {edge.get_source().get(), edge.get_dest().get()}) {
+	h = h * 31 + (v ? hash<Vertex>()(*v) : 0);
+      }
+      return h * 31 + (edge.value() ? ValueHash()(*edge.value()) : 0);
+    }
+  };
+}
@@ -0,0 +1,99 @@
+// splitmix64's finalizer, to spread keys such as sequential ids over a
+// table.
+uint64_t mix64(uint64_t key) {
+  key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+  return key ^ (key >> 31);
+}
+
+// A set of 64-bit keys in a single open-addressing table with linear
+// probing, for membership tests that cost one or two cache lines rather
+// than a std::set walk. Keys are never erased one by one; clear() and
+// re-insert instead.
+class IdSet {
+ public:
+  // (source id, dest id) packed into one key.
+  static uint64_t pair_key(int source, int dest) {
+    return (uint64_t(uint32_t(source)) << 32) | uint32_t(dest);
+  }
+
+  static uint64_t vertex_key(int id) {
+    return uint32_t(id);
+  }
+
+  // Returns false if key was already in the set.
+  bool insert(uint64_t key) {
+    if (key == kEmpty) {
+      bool inserted = !has_empty_key_;
+      has_empty_key_ = true;
+      size_ += inserted;
+      return inserted;
+    }
+    // Stay at most half full, so probe sequences stay short.
+    if (2 * (size_ + 1) > slots_.size()) {
+      grow_();
+    }
+    size_t mask = slots_.size() - 1;
+    for (size_t i = mix64(key) & mask; ; i = (i + 1) & mask) {
+      if (slots_[i] == key) {
+	return false;
+      }
+      if (slots_[i] == kEmpty) {
+	slots_[i] = key;
+	size_++;
+	return true;
+      }
+    }
+  }
+
+  bool contains(uint64_t key) const {
+    if (key == kEmpty) {
+      return has_empty_key_;
+    }
+    if (slots_.empty()) {
+      return false;
+    }
+    size_t mask = slots_.size() - 1;
+    for (size_t i = mix64(key) & mask; ; i = (i + 1) & mask) {
+      if (slots_[i] == key) {
+	return true;
+      }
+      if (slots_[i] == kEmpty) {
+	return false;
+      }
+    }
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  void clear() {
+    slots_.clear();
+    size_ = 0;
+    has_empty_key_ = false;
+  }
+
+ private:
+  // Marks a free slot; the key itself is tracked by has_empty_key_.
+  static constexpr uint64_t kEmpty = ~uint64_t(0);
+
+  vector<uint64_t> slots_;
+  size_t size_ = 0;
+  bool has_empty_key_ = false;
+
+  void grow_() {
+    vector<uint64_t> slots(std::max<size_t>(16, 2 * slots_.size()), kEmpty);
+    slots.swap(slots_);
+    size_t mask = slots_.size() - 1;
+    for (uint64_t key : slots) {
+      if (key != kEmpty) {
+	size_t i = mix64(key) & mask;
+	while (slots_[i] != kEmpty) {
+	  i = (i + 1) & mask;
+	}
+	slots_[i] = key;
+      }
+    }
+  }
+};
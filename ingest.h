@@ -0,0 +1,81 @@
+// Loads edges into a DirectedGraph from several threads at once. Each
+// thread appends to its own buffer (building the Edge, which is where the
+// allocations are, in parallel), and finish() hands the buffers over to
+// the graph.
+//
+// Ordering: edges added through the same thread slot keep their relative
+// order, and slots are appended to the graph in slot order (all of slot
+// 0, then all of slot 1, ...), after any edges the graph already had.
+// Nothing is visible in the graph before finish().
+class EdgeLoader {
+ public:
+  EdgeLoader(DirectedGraph* graph, int num_threads)
+    : graph_(graph), buffers_(graph_lib::thread_count(num_threads)) {}
+
+  ~EdgeLoader() {
+    finish();
+  }
+
+  int thread_count() const {
+    return buffers_.size();
+  }
+
+  // Each thread must stick to its own slot in [0, thread_count()).
+  bool add(int slot, const Vertex* v) {
+    Edge edge;
+    edge.set_source(*v);
+    buffers_[slot].edges.push_back(std::move(edge));
+    return true;
+  }
+
+  bool add_edge(int slot, const Vertex* u, const Vertex* v) {
+    Edge edge;
+    edge.set_source(*u);
+    edge.set_dest(*v);
+    buffers_[slot].edges.push_back(std::move(edge));
+    return true;
+  }
+
+  bool add_edge(int slot, const Edge* e) {
+    buffers_[slot].edges.push_back(Edge(*e));
+    return true;
+  }
+
+  // Appends everything loaded so far to the graph. Must not run
+  // concurrently with the add calls.
+  void finish() {
+    vector<vector<Edge>> batches;
+    for (Buffer& buffer : buffers_) {
+      batches.push_back(std::move(buffer.edges));
+      buffer.edges.clear();
+    }
+    graph_->append_edges(batches);
+  }
+
+ private:
+  // One cache line per thread, so that the vectors' bookkeeping is not
+  // falsely shared between threads.
+  struct alignas(64) Buffer {
+    vector<Edge> edges;
+  };
+
+  DirectedGraph* graph_;
+  vector<Buffer> buffers_;
+};
+
+namespace graph_lib {
+  // Adds an edge for every (source, dest) pair with num_threads threads,
+  // each loading a contiguous range of the pairs; the graph ends up with
+  // the edges in the same order as pairs.
+  void load_edges(DirectedGraph& g, const vector<std::pair<Value, Value>>& pairs, int num_threads = 0) {
+    EdgeLoader loader(&g, num_threads);
+    parallel_for(pairs.size(), loader.thread_count(), [&](size_t begin, size_t end, int slot) {
+      for (size_t i = begin; i < end; i++) {
+	Vertex u(pairs[i].first);
+	Vertex v(pairs[i].second);
+	loader.add_edge(slot, &u, &v);
+      }
+    });
+    loader.finish();
+  }
+}
@@ -3,9 +3,23 @@
 #include <typeinfo>
 #include <vector>
 #include "graphs.h"
+#include "idset.h"
+#include "bloom.h"
 #include "dg.h"
+#include "critical.h"
 #include "dag.h"
 #include "tree.h"
+#include "cg.h"
+#include "components.h"
+#include "pagerank.h"
+#include "intersect.h"
+#include "reorder.h"
+#include "compressed.h"
+#include "cdg.h"
+#include "ingest.h"
+#include "msbfs.h"
+#include "subgraph.h"
+#include "succinct.h"
 
 using std::cout;
 using std::make_pair;
@@ -428,6 +442,794 @@ void test_top() {
   assert(v1 == *graph_lib::top(tree));
 }
 
+void test_connected_components() {
+  DirectedGraph dg;
+  Vertex v1(make_pair("A", 1));
+  Vertex v2(make_pair("B", 2));
+  Vertex v3(make_pair("C", 3));
+  Vertex v4(make_pair("D", 4));
+  Vertex v5(make_pair("E", 5));
+  Vertex v6(make_pair("F", 6));
+
+  // {1, 2, 3} are only weakly connected (both edges point at 2), {4, 5}
+  // is a second component and 6 is isolated.
+  dg.add_edge(&v1, &v2);
+  dg.add_edge(&v3, &v2);
+  dg.add_edge(&v5, &v4);
+  dg.add(&v6);
+
+  for (int num_threads : {1, 4}) {
+    std::map<int, int> components = graph_lib::connected_components(dg, num_threads);
+    assert(components.size() == 6);
+    assert(components[1] == components[2]);
+    assert(components[2] == components[3]);
+    assert(components[4] == components[5]);
+    assert(components[1] != components[4]);
+    assert(components[6] == 6);
+    assert(graph_lib::count_components(dg, num_threads) == 3);
+  }
+
+  DirectedAcyclicGraph dag;
+  dag.add_edge(&v1, &v2);
+  dag.add_edge(&v3, &v4);
+  assert(graph_lib::count_components(dag) == 2);
+  dag.add_edge(&v2, &v3);
+  assert(graph_lib::count_components(dag) == 1);
+
+  Tree tree;
+  tree.add_edge(&v1, &v2);
+  tree.add_edge(&v1, &v3);
+  assert(graph_lib::count_components(tree) == 1);
+}
+
+void test_pagerank() {
+  DirectedGraph dg;
+  Vertex v1(make_pair("A", 1));
+  Vertex v2(make_pair("B", 2));
+  Vertex v3(make_pair("C", 3));
+  Vertex v4(make_pair("D", 4));
+
+  // A cycle spreads the rank evenly.
+  dg.add_edge(&v1, &v2);
+  dg.add_edge(&v2, &v3);
+  dg.add_edge(&v3, &v1);
+  std::map<int, float> ranks = graph_lib::pagerank(dg);
+  assert(ranks.size() == 3);
+  for (auto& rank : ranks) {
+    assert(std::abs(rank.second - 1.0f / 3) < 1e-4);
+  }
+
+  // 4 is dangling and only linked to from 1: its rank ends up between
+  // that of 1 (which is linked to from the cycle) and 0.
+  dg.add_edge(&v1, &v4);
+  PropagationOptions options;
+  options.num_threads = 2;
+  ranks = graph_lib::pagerank(dg, 0.85, options);
+  float total = 0;
+  for (auto& rank : ranks) {
+    total += rank.second;
+  }
+  assert(std::abs(total - 1) < 1e-4);
+  assert(ranks[4] > 0 && ranks[4] < ranks[1]);
+  assert(std::abs(ranks[2] - ranks[4]) < 1e-4);
+
+  CompactGraph cg = graph_lib::compact(dg);
+  vector<float> scores;
+  PropagationStats stats = graph_lib::pagerank(cg, scores, 0.85, options);
+  assert(stats.iterations > 1 && stats.iterations < options.max_iterations);
+  assert(stats.delta < options.tolerance);
+}
+
+void test_intersect() {
+  // Long enough to go through the vectorized blocks and the scalar tail.
+  vector<int> a, b;
+  for (int i = 0; i < 200; i++) {
+    if (i % 2 == 0) {
+      a.push_back(i);
+    }
+    if (i % 3 == 0) {
+      b.push_back(i);
+    }
+  }
+  vector<int> common(a.size());
+  size_t count = graph_lib::intersect(a.data(), a.size(), b.data(), b.size(), common.data());
+  assert(count == 34);
+  assert(count == graph_lib::intersect_scalar(a.data(), a.size(), b.data(), b.size()));
+  assert(count == graph_lib::intersect(b.data(), b.size(), a.data(), a.size()));
+  for (size_t i = 0; i < count; i++) {
+    assert(common[i] == 6 * int(i));
+  }
+  assert(graph_lib::intersect(a.data(), 0, b.data(), b.size()) == 0);
+}
+
+void test_common_neighbors() {
+  DirectedGraph dg;
+  Vertex v1(make_pair("A", 1));
+  Vertex v2(make_pair("B", 2));
+  Vertex v3(make_pair("C", 3));
+  Vertex v4(make_pair("D", 4));
+  Vertex v5(make_pair("E", 5));
+
+  dg.add_edge(&v1, &v3);
+  dg.add_edge(&v1, &v4);
+  dg.add_edge(&v1, &v4);
+  dg.add_edge(&v2, &v4);
+  dg.add_edge(&v2, &v5);
+  dg.add_edge(&v2, &v1);
+
+  NeighborIndex index = graph_lib::neighbor_index(dg);
+  vector<int> common = index.common_neighbors(&v1, &v2);
+  assert(common.size() == 1 && common[0] == 4);
+  assert(index.common_neighbors(&v1, &v3).empty());
+  // {3, 4} & {4, 5, 1} = {4}, out of {1, 3, 4, 5}.
+  assert(std::abs(index.jaccard(&v1, &v2) - 0.25f) < 1e-6);
+  assert(index.jaccard(&v3, &v4) == 0);
+
+  // 1 - 2 - 4 is the only triangle so far (1 -> 4 counted once).
+  assert(graph_lib::count_triangles(dg) == 1);
+  dg.add_edge(&v5, &v4);
+  dg.add_edge(&v3, &v3);
+  assert(graph_lib::count_triangles(dg, 1) == 2);
+  assert(graph_lib::count_triangles(dg, 4) == 2);
+
+  Tree tree;
+  tree.add_edge(&v1, &v2);
+  tree.add_edge(&v1, &v3);
+  assert(graph_lib::count_triangles(tree) == 0);
+}
+
+void test_reorder() {
+  // A path 1 - 2 - ... - 8 whose edges are added out of order, so the
+  // first-seen indices are scattered along it.
+  DirectedGraph dg;
+  vector<Vertex> vertices;
+  for (int i = 1; i <= 8; i++) {
+    vertices.push_back(Vertex(make_pair("V", i)));
+  }
+  for (int i : {4, 0, 6, 2, 5, 1, 3}) {
+    dg.add_edge(&vertices[i], &vertices[i + 1]);
+  }
+  auto bandwidth = [](const CompactGraph& cg) {
+    int width = 0;
+    for (size_t e = 0; e < cg.edge_count(); e++) {
+      width = std::max(width, std::abs(cg.source(e) - cg.dest(e)));
+    }
+    return width;
+  };
+
+  CompactGraph first_seen = graph_lib::compact(dg);
+  assert(bandwidth(first_seen) > 1);
+  for (Ordering kind : {Ordering::kDegree, Ordering::kBfs, Ordering::kReverseCuthillMcKee}) {
+    CompactGraph cg = graph_lib::compact(dg, kind);
+    assert(cg.vertex_count() == 8);
+    assert(cg.edge_count() == 7);
+    // Relabeling keeps the ids and the edges between them.
+    for (int v = 0; v < cg.vertex_count(); v++) {
+      assert(cg.index(cg.id(v)) == v);
+    }
+    for (size_t e = 0; e < cg.edge_count(); e++) {
+      assert(cg.id(cg.dest(e)) == cg.id(cg.source(e)) + 1);
+    }
+    if (kind == Ordering::kReverseCuthillMcKee) {
+      assert(bandwidth(cg) == 1);
+    }
+  }
+
+  // The hub of a star comes first in degree order.
+  Tree tree;
+  tree.add_edge(&vertices[1], &vertices[0]);
+  tree.add_edge(&vertices[0], &vertices[2]);
+  tree.add_edge(&vertices[0], &vertices[3]);
+  CompactGraph cg = graph_lib::compact(tree, Ordering::kDegree);
+  assert(cg.id(0) == 1);
+}
+
+void test_compressed() {
+  DirectedGraph dg;
+  vector<Vertex> vertices;
+  for (int i = 0; i < 300; i++) {
+    vertices.push_back(Vertex(make_pair("V", 1000 - i)));
+  }
+  // Vertex 299 points back at everything (negative first offsets, gaps
+  // needing more than one byte once reordered), everything else points
+  // at its successor.
+  for (int i = 0; i < 299; i++) {
+    dg.add_edge(&vertices[i], &vertices[i + 1]);
+    dg.add_edge(&vertices[299], &vertices[i]);
+  }
+  dg.add_edge(&vertices[0], &vertices[1]);
+
+  for (Ordering kind : {Ordering::kFirstSeen, Ordering::kDegree, Ordering::kReverseCuthillMcKee}) {
+    CompressedGraph cg = graph_lib::compress(dg, kind);
+    assert(cg.vertex_count() == 300);
+    // The duplicate 0 -> 1 edge is dropped.
+    assert(cg.edge_count() == 2 * 299);
+    for (int i = 0; i < 300; i++) {
+      vector<int> expected;
+      for (Vertex* neighbor : dg.get_neighbors(&vertices[i])) {
+	expected.push_back(neighbor->value().second);
+      }
+      std::sort(expected.begin(), expected.end());
+      expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+      vector<int> actual = cg.get_neighbors(&vertices[i]);
+      std::sort(actual.begin(), actual.end());
+      assert(actual == expected);
+      assert(cg.degree(cg.index(1000 - i)) == int(expected.size()));
+    }
+    assert(cg.are_adjacent(&vertices[0], &vertices[1]));
+    assert(!cg.are_adjacent(&vertices[1], &vertices[0]));
+    assert(cg.are_adjacent(&vertices[299], &vertices[150]));
+    assert(cg.bytes_per_edge() < 4);
+  }
+
+  Vertex missing(make_pair("Z", 0));
+  CompressedGraph cg = graph_lib::compress(dg);
+  assert(cg.get_neighbors(&missing).empty());
+  assert(!cg.are_adjacent(&missing, &vertices[0]));
+}
+
+void test_concurrent_snapshots() {
+  ConcurrentDirectedGraph cdg;
+  Vertex v1(make_pair("A", 1));
+  Vertex v2(make_pair("B", 2));
+  Vertex v3(make_pair("C", 3));
+
+  cdg.add_edge(&v1, &v2);
+  ConcurrentDirectedGraph::Snapshot before = cdg.snapshot();
+  vector<const Vertex*> neighbors = before.get_neighbors(&v1);
+  assert(neighbors.size() == 1);
+
+  // Later writes, including a removal that rebuilds the storage, are not
+  // visible to an earlier snapshot, and its pointers stay valid.
+  cdg.add_edge(&v1, &v3);
+  cdg.remove(&v1);
+  cdg.add_edge(&v2, &v3);
+  assert(before.edge_count() == 1);
+  assert(before.are_adjacent(&v1, &v2));
+  assert(*neighbors[0] == v2);
+
+  ConcurrentDirectedGraph::Snapshot after = cdg.snapshot();
+  assert(after.edge_count() == 1);
+  assert(!after.are_adjacent(&v1, &v2));
+  assert(after.are_adjacent(&v2, &v3));
+  assert(*after.top() == v2);
+  assert(after.vertex_count() == 2);
+
+  // Readers keep taking snapshots while the writer appends across many
+  // chunks: every snapshot is a prefix of the final edge list.
+  const int kEdges = 5000;
+  std::atomic<bool> done(false);
+  vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&]() {
+      int seen = 0;
+      while (!done.load()) {
+	ConcurrentDirectedGraph::Snapshot snapshot = cdg.snapshot();
+	int count = snapshot.edge_count();
+	assert(count >= seen);
+	seen = count;
+	vector<Edge> edges = snapshot.get_adjacency_list();
+	for (size_t i = 1; i < edges.size(); i++) {
+	  assert(edges[i].get_source()->value().second == int(i) + 99);
+	}
+      }
+    });
+  }
+  for (int i = 100; i < 100 + kEdges; i++) {
+    Vertex u(make_pair("U", i));
+    cdg.add_edge(&u, &v3);
+  }
+  done.store(true);
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  assert(cdg.snapshot().edge_count() == kEdges + 1);
+
+  // More threads alive at once than there used to be epoch slots: none
+  // of them waits for another to exit before it can read.
+  const int kThreads = 200;
+  std::atomic<int> snapshots(0);
+  vector<std::thread> idle;
+  for (int t = 0; t < kThreads; t++) {
+    idle.emplace_back([&]() {
+      assert(cdg.snapshot().edge_count() == kEdges + 1);
+      snapshots++;
+      while (snapshots.load() < kThreads) {
+	std::this_thread::yield();
+      }
+    });
+  }
+  for (std::thread& thread : idle) {
+    thread.join();
+  }
+  assert(EpochManager::instance().slot_count() >= kThreads);
+  // Slots of exited threads are reused.
+  int slots = EpochManager::instance().slot_count();
+  std::thread([&]() { cdg.snapshot(); }).join();
+  assert(EpochManager::instance().slot_count() == slots);
+}
+
+void test_parallel_load() {
+  DirectedGraph dg;
+  Vertex v1(make_pair("A", 1));
+  Vertex v2(make_pair("B", 2));
+  dg.add_edge(&v1, &v2);
+
+  vector<std::pair<Value, Value>> pairs;
+  for (int i = 0; i < 1000; i++) {
+    pairs.push_back(make_pair(Value(make_pair("U", i)), Value(make_pair("V", i + 1))));
+  }
+  graph_lib::load_edges(dg, pairs, 4);
+  assert(dg.edge_count() == 1001);
+  assert(dg.vertex_count() == 1001);
+  const vector<Edge>& edges = dg.edges();
+  assert(*edges[0].get_source() == v1);
+  for (int i = 0; i < 1000; i++) {
+    assert(edges[i + 1].get_source()->value().second == i);
+    assert(edges[i + 1].get_dest()->value().second == i + 1);
+  }
+
+  // Slots are appended in slot order, whatever order the threads ran in.
+  DirectedGraph loaded;
+  {
+    EdgeLoader loader(&loaded, 2);
+    std::thread second([&]() { loader.add_edge(1, &v2, &v1); });
+    second.join();
+    loader.add(0, &v1);
+    loader.add_edge(0, &v1, &v2);
+    assert(loaded.edges().empty());
+  }
+  assert(loaded.edges().size() == 3);
+  assert(loaded.edge_count() == 2);
+  assert(!loaded.edges()[0].get_dest());
+  assert(*loaded.edges()[2].get_source() == v2);
+}
+
+void test_hash() {
+  Vertex v1(make_pair("A", 1));
+  Vertex v2(make_pair("B", 2));
+  Vertex copy(v1);
+  assert(std::hash<Vertex>()(v1) == std::hash<Vertex>()(copy));
+
+  std::unordered_set<Vertex> vertices = {v1, v2, copy};
+  assert(vertices.size() == 2);
+
+  Edge e1(std::make_unique<Vertex>(v1), std::make_unique<Vertex>(v2), std::make_unique<Value>(kDummyValue));
+  Edge e2(e1);
+  assert(e1 == e2);
+  assert(std::hash<Edge>()(e1) == std::hash<Edge>()(e2));
+  assert(ValueHash()(v1.value()) == ValueHash()(copy.value()));
+
+  IdSet ids;
+  for (int i = -1; i < 1000; i++) {
+    assert(ids.insert(IdSet::pair_key(i, i)));
+  }
+  assert(!ids.insert(IdSet::pair_key(-1, -1)));
+  assert(!ids.insert(IdSet::pair_key(500, 500)));
+  assert(ids.contains(IdSet::pair_key(999, 999)));
+  assert(!ids.contains(IdSet::pair_key(999, 998)));
+  assert(ids.size() == 1001);
+}
+
+void test_simple_graph() {
+  DirectedGraph dg(true);
+  Vertex v1(make_pair("A", 1));
+  Vertex v2(make_pair("B", 2));
+  Vertex v3(make_pair("C", 3));
+
+  assert(dg.add(&v1));
+  assert(!dg.add(&v1));
+  assert(dg.add_edge(&v1, &v2));
+  assert(!dg.add_edge(&v1, &v2));
+  // v2 is already in the graph as the end of an edge.
+  assert(!dg.add(&v2));
+  Edge e1(std::make_unique<Vertex>(v1), std::make_unique<Vertex>(v2), std::make_unique<Value>(kDummyValue));
+  assert(!graph_lib::add_edge(dg, &e1));
+  assert(dg.add_edge(&v2, &v1));
+  assert(dg.edge_count() == 2);
+  assert(dg.vertex_count() == 2);
+  assert(dg.are_adjacent(&v1, &v2));
+  assert(!dg.are_adjacent(&v1, &v3));
+
+  // Once removed, an edge can be added again.
+  dg.remove_edge(&e1);
+  assert(!dg.are_adjacent(&v1, &v2));
+  assert(dg.add_edge(&v1, &v2));
+  assert(dg.edge_count() == 2);
+
+  // Repeated loads of overlapping data do not grow the graph.
+  vector<std::pair<Value, Value>> pairs;
+  for (int i = 0; i < 100; i++) {
+    pairs.push_back(make_pair(v1.value(), Value(make_pair("V", 10 + i % 10))));
+  }
+  graph_lib::load_edges(dg, pairs, 4);
+  graph_lib::load_edges(dg, pairs, 4);
+  assert(dg.edge_count() == 12);
+  assert(dg.vertex_count() == 12);
+
+  DirectedAcyclicGraph dag(true);
+  assert(dag.add_edge(&v1, &v2));
+  assert(!dag.add_edge(&v1, &v2));
+  assert(!dag.add_edge(&v2, &v1));
+  assert(dag.add_edge(&v2, &v3));
+  assert(dag.edge_count() == 2);
+}
+
+void test_critical_path() {
+  Vertex a(make_pair("A", 1));
+  Vertex b(make_pair("B", 2));
+  Vertex c(make_pair("C", 3));
+  Vertex d(make_pair("D", 4));
+  Vertex e(make_pair("E", 5));
+  auto weighted = [](const Vertex& u, const Vertex& v, int weight) {
+    return Edge(std::make_unique<Vertex>(u), std::make_unique<Vertex>(v),
+		std::make_unique<Value>(make_pair("w", weight)));
+  };
+  Edge ab = weighted(a, b, 3);
+  Edge bd = weighted(b, d, 2);
+  Edge ac = weighted(a, c, 1);
+  Edge cd = weighted(c, d, 1);
+
+  DirectedAcyclicGraph dag;
+  assert(dag.critical_path_length() == 0);
+  assert(dag.critical_path().empty());
+  dag.add_edge(&ab);
+  dag.add_edge(&bd);
+  dag.add_edge(&ac);
+  dag.add_edge(&cd);
+  // Without a value, an edge weighs 1.
+  dag.add_edge(&d, &e);
+
+  assert(dag.depth(&a) == 0);
+  assert(dag.depth(&b) == 3);
+  assert(dag.depth(&c) == 1);
+  assert(dag.depth(&d) == 5);
+  assert(dag.depth(&e) == 6);
+  assert(dag.height(&a) == 6);
+  assert(dag.height(&c) == 2);
+  assert(dag.critical_path_length() == 6);
+  assert(dag.critical_path() == vector<int>({1, 2, 4, 5}));
+  assert(dag.on_critical_path(&b));
+  assert(!dag.on_critical_path(&c));
+
+  // A rejected cycle changes nothing.
+  assert(!dag.add_edge(&e, &a));
+  assert(dag.critical_path_length() == 6);
+
+  dag.remove_edge(&ab);
+  assert(dag.depth(&b) == 0);
+  assert(dag.depth(&d) == 2);
+  assert(dag.depth(&e) == 3);
+  assert(dag.height(&a) == 3);
+  assert(dag.critical_path_length() == 3);
+  assert(dag.on_critical_path(&c));
+
+  dag.remove(&c);
+  assert(dag.depth(&d) == 2);
+  assert(dag.height(&a) == 1);
+  assert(dag.critical_path() == vector<int>({2, 4, 5}));
+  assert(!dag.on_critical_path(&a));
+
+  // Copies keep their own analytics.
+  DirectedAcyclicGraph copy(dag);
+  copy.add_edge(&e, &c);
+  assert(copy.critical_path_length() == 4);
+  assert(dag.critical_path_length() == 3);
+
+  // The cached length follows vertices that gain or lose their last
+  // predecessor even when no height changes.
+  CriticalPath path;
+  path.add_edge(1, 2, 5);
+  path.add_edge(3, 1, -2);
+  assert(path.length() == 3);
+  path.remove_edge(3, 1, -2);
+  assert(path.length() == 5);
+  path.add_edge(4, 1, 0);
+  assert(path.length() == 5);
+  assert(path.on_critical_path(4));
+  assert(!path.on_critical_path(3));
+
+  // Asking every vertex of a wide graph is linear overall.
+  const int kWidth = 100000;
+  for (int i = 10; i < kWidth; i++) {
+    path.add_edge(4, i, 10);
+  }
+  int on_path = 0;
+  for (int i = 10; i < kWidth; i++) {
+    on_path += path.on_critical_path(i);
+  }
+  assert(path.length() == 10);
+  assert(on_path == kWidth - 10);
+}
+
+void test_multi_source_bfs() {
+  DirectedGraph dg;
+  Vertex v1(make_pair("A", 1));
+  Vertex v2(make_pair("B", 2));
+  Vertex v3(make_pair("C", 3));
+  Vertex v4(make_pair("D", 4));
+  Vertex missing(make_pair("Z", 9));
+  dg.add_edge(&v1, &v2);
+  dg.add_edge(&v2, &v3);
+  dg.add_edge(&v1, &v3);
+  dg.add_edge(&v3, &v4);
+
+  DistanceMatrix matrix = graph_lib::batch_distances(dg, {&v1, &v3, &missing});
+  assert(matrix.vertex_ids == vector<int>({1, 2, 3, 4}));
+  assert(matrix.at(0, 0) == 0);
+  assert(matrix.at(0, 1) == 1);
+  assert(matrix.at(0, 2) == 1);
+  assert(matrix.at(0, 3) == 2);
+  assert(matrix.at(1, 0) == -1);
+  assert(matrix.at(1, 2) == 0);
+  assert(matrix.at(1, 3) == 1);
+  for (int v = 0; v < 4; v++) {
+    assert(matrix.at(2, v) == -1);
+  }
+
+  // More sources than fit in one batch, against one BFS per source.
+  DirectedGraph ring;
+  vector<Vertex> vertices;
+  for (int i = 0; i < 150; i++) {
+    vertices.push_back(Vertex(make_pair("V", i)));
+  }
+  for (int i = 0; i < 150; i++) {
+    ring.add_edge(&vertices[i], &vertices[(i + 1) % 150]);
+    if (i % 7 == 0) {
+      ring.add_edge(&vertices[i], &vertices[(i * 3) % 150]);
+    }
+  }
+  CompactGraph cg = graph_lib::compact(ring);
+  Adjacency out = cg.out_edges();
+  vector<int> sources;
+  for (int i = 0; i < 150; i++) {
+    sources.push_back((i * 11) % 150);
+  }
+  DistanceMatrix narrow = graph_lib::multi_source_bfs<1>(cg, sources, 2);
+  DistanceMatrix wide = graph_lib::multi_source_bfs<4>(cg, sources, 2);
+  for (size_t i = 0; i < sources.size(); i++) {
+    vector<int> expected = graph_lib::bfs_distances(out, sources[i]);
+    for (int v = 0; v < cg.vertex_count(); v++) {
+      assert(narrow.at(i, v) == expected[v]);
+      assert(wide.at(i, v) == expected[v]);
+    }
+  }
+}
+
+void test_adjacency_filter() {
+  BloomFilter filter(10000, 0.01);
+  for (int i = 0; i < 10000; i++) {
+    filter.insert(IdSet::pair_key(i, i + 1));
+  }
+  int false_positives = 0;
+  for (int i = 0; i < 10000; i++) {
+    assert(filter.may_contain(IdSet::pair_key(i, i + 1)));
+    false_positives += filter.may_contain(IdSet::pair_key(i + 1, i));
+  }
+  assert(false_positives < 300);
+  assert(!filter.needs_rebuild());
+
+  for (bool simple : {false, true}) {
+    DirectedGraph dg(simple);
+    dg.set_adjacency_filter(0.01);
+    vector<Vertex> vertices;
+    for (int i = 0; i < 200; i++) {
+      vertices.push_back(Vertex(make_pair("V", i)));
+    }
+    // Enough edges to outgrow the first filter.
+    for (int i = 0; i < 199; i++) {
+      dg.add_edge(&vertices[i], &vertices[i + 1]);
+    }
+    vector<std::pair<const Vertex*, const Vertex*>> pairs;
+    for (int i = 0; i < 199; i++) {
+      assert(dg.are_adjacent(&vertices[i], &vertices[i + 1]));
+      assert(!dg.are_adjacent(&vertices[i + 1], &vertices[i]));
+      pairs.push_back(make_pair(&vertices[i], &vertices[i + 1]));
+      pairs.push_back(make_pair(&vertices[i + 1], &vertices[i]));
+    }
+    // Same id, different name: not the same vertex.
+    Vertex impostor(make_pair("W", 1));
+    pairs.push_back(make_pair(&vertices[0], &impostor));
+
+    vector<bool> adjacent = dg.are_adjacent(pairs);
+    for (size_t i = 0; i + 1 < pairs.size(); i++) {
+      assert(adjacent[i] == (i % 2 == 0));
+    }
+    assert(adjacent.back() == simple);
+
+    Edge e(std::make_unique<Vertex>(vertices[0]), std::make_unique<Vertex>(vertices[1]),
+	   std::make_unique<Value>(kDummyValue));
+    dg.remove_edge(&e);
+    assert(!dg.are_adjacent(&vertices[0], &vertices[1]));
+    assert(!dg.are_adjacent(pairs)[0]);
+    dg.add_edge(&vertices[0], &vertices[1]);
+    assert(dg.are_adjacent(&vertices[0], &vertices[1]));
+  }
+
+  // The DAG and Tree forward the filter; an edge rejected for closing a
+  // cycle must not linger in it.
+  Vertex a(make_pair("A", 1)), b(make_pair("B", 2)), c(make_pair("C", 3));
+  DirectedAcyclicGraph dag;
+  dag.set_adjacency_filter(0.01);
+  dag.add_edge(&a, &b);
+  dag.add_edge(&b, &c);
+  assert(!dag.add_edge(&c, &a));
+  assert(dag.are_adjacent(&a, &b));
+  assert(!dag.are_adjacent(&c, &a));
+  assert(dag.are_adjacent({make_pair(&b, &c), make_pair(&c, &a)}) == vector<bool>({true, false}));
+  Tree tree;
+  tree.set_adjacency_filter(0.01);
+  tree.add_edge(&a, &b);
+  tree.add_edge(&a, &c);
+  assert(tree.are_adjacent(&a, &c));
+  assert(!tree.are_adjacent(&b, &c));
+  assert(tree.are_adjacent({make_pair(&a, &b), make_pair(&c, &a)}) == vector<bool>({true, false}));
+}
+
+void test_subgraph() {
+  vector<Vertex> v;
+  for (int i = 0; i <= 7; i++) {
+    v.push_back(Vertex(make_pair("V", i)));
+  }
+  DirectedAcyclicGraph dag;
+  dag.add_edge(&v[1], &v[2]);
+  dag.add_edge(&v[2], &v[3]);
+  dag.add_edge(&v[3], &v[4]);
+  dag.add_edge(&v[1], &v[5]);
+  dag.add_edge(&v[6], &v[1]);
+  dag.add(&v[7]);
+
+  vector<int> ids = graph_lib::k_hop_neighborhood(dag, {&v[1]}, 2);
+  std::sort(ids.begin(), ids.end());
+  assert(ids == vector<int>({1, 2, 3, 5}));
+
+  DirectedAcyclicGraph two_hops = graph_lib::k_hop_subgraph(dag, {&v[1]}, 2);
+  assert(two_hops.edge_count() == 3);
+  assert(two_hops.vertex_count() == 4);
+  assert(two_hops.are_adjacent(&v[2], &v[3]));
+  assert(!two_hops.are_adjacent(&v[3], &v[4]));
+  assert(two_hops.critical_path_length() == 2);
+  // Still a DAG: cycles are rejected.
+  assert(!two_hops.add_edge(&v[3], &v[1]));
+
+  // Seeds without edges in the subgraph are kept as vertices.
+  DirectedAcyclicGraph seeds = graph_lib::k_hop_subgraph(dag, {&v[4], &v[7]}, 0);
+  assert(seeds.edge_count() == 0);
+  assert(seeds.vertex_count() == 2);
+
+  DirectedGraph dg;
+  for (int i = 0; i < 3000; i++) {
+    Vertex u(make_pair("U", i));
+    Vertex w(make_pair("U", (i + 1) % 3000));
+    dg.add_edge(&u, &w);
+  }
+  Vertex u0(make_pair("U", 0)), u5(make_pair("U", 5)), u6(make_pair("U", 6));
+  DirectedGraph ring = graph_lib::induced_subgraph(dg, graph_lib::k_hop_neighborhood(dg, {&u0}, 5), 4);
+  assert(ring.edge_count() == 5);
+  assert(ring.vertex_count() == 6);
+  assert(ring.get_neighbors(&u5).empty());
+  assert(!ring.are_adjacent(&u5, &u6));
+
+  Tree tree;
+  tree.add_edge(&v[1], &v[2]);
+  tree.add_edge(&v[1], &v[3]);
+  tree.add_edge(&v[3], &v[4]);
+  Tree subtree = graph_lib::k_hop_subgraph(tree, {&v[3]}, 3);
+  assert(subtree.edge_count() == 1);
+  assert(*subtree.top() == v[3]);
+  // Edges of a Tree are always copied, forests included, and unknown ids
+  // are ignored.
+  tree.add_edge(&v[6], &v[7]);
+  Tree forest = graph_lib::induced_subgraph(tree, {1, 2, 6, 7});
+  assert(forest.edge_count() == 2);
+  assert(forest.are_adjacent(&v[6], &v[7]));
+  assert(graph_lib::induced_subgraph(tree, {1, 2, 99}).edge_count() == 1);
+  Tree leaf = graph_lib::induced_subgraph(tree, {4});
+  assert(leaf.vertex_count() == 1 && leaf.edge_count() == 0);
+  // Like Tree::add, vertex records are only taken while the Tree is empty:
+  // one isolated member is kept when no edge was copied, none otherwise.
+  Tree siblings = graph_lib::induced_subgraph(tree, {2, 3});
+  assert(siblings.vertex_count() == 1 && siblings.edge_count() == 0);
+  Tree hops = graph_lib::k_hop_subgraph(tree, {&v[2], &v[3]}, 1);
+  assert(hops.edge_count() == 1);
+  assert(hops.are_adjacent(&v[3], &v[4]));
+  assert(graph_lib::k_hop_subgraph(dag, {&v[2], &v[7]}, 0).vertex_count() == 2);
+
+  // A simple source gives a simple subgraph.
+  DirectedGraph simple(true);
+  simple.add_edge(&v[1], &v[2]);
+  simple.add_edge(&v[2], &v[3]);
+  DirectedGraph simple_subgraph = graph_lib::induced_subgraph(simple, {1, 2});
+  assert(simple_subgraph.is_simple());
+  assert(!simple_subgraph.add_edge(&v[1], &v[2]));
+  assert(!graph_lib::induced_subgraph(dg, {0, 1}).is_simple());
+}
+
+// A tree with parents[i] < i for every i > 0, appended in one batch.
+Tree tree_from_parents(const vector<int>& parents) {
+  vector<vector<Edge>> batches(1);
+  for (size_t i = 1; i < parents.size(); i++) {
+    batches[0].push_back(Edge(std::make_unique<Vertex>(make_pair("T", parents[i])),
+			      std::make_unique<Vertex>(make_pair("T", int(i))),
+			      std::make_unique<Value>(kDummyValue)));
+  }
+  Tree tree;
+  tree.append_edges(batches);
+  return tree;
+}
+
+void test_succinct_tree() {
+  vector<Vertex> v;
+  for (int i = 0; i <= 8; i++) {
+    v.push_back(Vertex(make_pair("V", i)));
+  }
+  Tree tree;
+  tree.add_edge(&v[1], &v[2]);
+  tree.add_edge(&v[1], &v[3]);
+  tree.add_edge(&v[2], &v[4]);
+  tree.add_edge(&v[2], &v[5]);
+  tree.add_edge(&v[3], &v[6]);
+  tree.add_edge(&v[7], &v[8]);
+  SuccinctTree succinct = graph_lib::succinct(tree);
+  assert(succinct.size() == 8);
+  int root = succinct.root();
+  assert(succinct.id(root) == 1);
+  assert(succinct.parent(root) == -1);
+  assert(succinct.subtree_size(root) == 6);
+  assert(succinct.first_child(root) == succinct.find(2));
+  assert(succinct.next_sibling(succinct.find(2)) == succinct.find(3));
+  assert(succinct.next_sibling(succinct.find(3)) == -1);
+  assert(succinct.parent(succinct.find(5)) == succinct.find(2));
+  assert(succinct.parent(succinct.find(6)) == succinct.find(3));
+  assert(succinct.first_child(succinct.find(4)) == -1);
+  assert(succinct.depth(succinct.find(6)) == 2);
+  assert(succinct.subtree_size(succinct.find(2)) == 3);
+  // A second root is the next sibling of the first.
+  assert(succinct.next_sibling(root) == succinct.find(7));
+  assert(succinct.parent(succinct.find(7)) == -1);
+  assert(succinct.depth(succinct.find(8)) == 1);
+  assert(succinct.find(0) == -1);
+  for (int i = 0; i < succinct.size(); i++) {
+    assert(succinct.preorder(succinct.node(i)) == i);
+  }
+
+  // Compare with the parent array on a bushy and a deep tree, both large
+  // enough to span many blocks.
+  for (bool deep : {true, false}) {
+    const int kNodes = 20000;
+    vector<int> parents(kNodes, -1);
+    for (int i = 1; i < kNodes; i++) {
+      parents[i] = deep ? i - 1 - (i % 3 == 0) : mix64(i) % i;
+    }
+    Tree large_tree = tree_from_parents(parents);
+    SuccinctTree large = graph_lib::succinct(large_tree);
+    assert(large.size() == kNodes);
+    vector<int> depths(kNodes, 0), sizes(kNodes, 1);
+    for (int i = 1; i < kNodes; i++) {
+      depths[i] = depths[parents[i]] + 1;
+    }
+    for (int i = kNodes - 1; i > 0; i--) {
+      sizes[parents[i]] += sizes[i];
+    }
+    vector<vector<int>> children(kNodes);
+    for (int i = 1; i < kNodes; i++) {
+      children[parents[i]].push_back(i);
+    }
+    for (int i = 0; i < kNodes; i++) {
+      int node = large.find(i);
+      assert(large.id(node) == i);
+      assert(large.parent(node) == (i == 0 ? -1 : large.find(parents[i])));
+      assert(large.depth(node) == depths[i]);
+      assert(large.subtree_size(node) == sizes[i]);
+      vector<int> ids;
+      for (int child = large.first_child(node); child >= 0; child = large.next_sibling(child)) {
+	ids.push_back(large.id(child));
+      }
+      assert(ids == children[i]);
+    }
+  }
+}
+
 int main() {
   assert(__cpp_concepts >= 201500); // check compiled with -fconcepts
   assert(__cplusplus >= 201500);    // check compiled with --std=c++1z
@@ -456,5 +1258,35 @@ int main() {
   test_set_edge_value();
   cout << "Testing top().\n";
   test_top();
+  cout << "Testing connected_components().\n";
+  test_connected_components();
+  cout << "Testing pagerank().\n";
+  test_pagerank();
+  cout << "Testing intersect().\n";
+  test_intersect();
+  cout << "Testing common_neighbors().\n";
+  test_common_neighbors();
+  cout << "Testing reorder().\n";
+  test_reorder();
+  cout << "Testing compress().\n";
+  test_compressed();
+  cout << "Testing ConcurrentDirectedGraph snapshots.\n";
+  test_concurrent_snapshots();
+  cout << "Testing load_edges().\n";
+  test_parallel_load();
+  cout << "Testing hashing.\n";
+  test_hash();
+  cout << "Testing simple graphs.\n";
+  test_simple_graph();
+  cout << "Testing critical paths.\n";
+  test_critical_path();
+  cout << "Testing batch_distances().\n";
+  test_multi_source_bfs();
+  cout << "Testing adjacency filter.\n";
+  test_adjacency_filter();
+  cout << "Testing k_hop_subgraph().\n";
+  test_subgraph();
+  cout << "Testing SuccinctTree.\n";
+  test_succinct_tree();
   cout << "All tests passed.\n";
 }
@@ -0,0 +1,136 @@
+// Hop distances from a batch of sources: row i holds the distance from
+// sources[i] to every vertex, -1 where it cannot be reached. Columns are
+// the dense indices of the CompactGraph the matrix was computed on, and
+// vertex_ids maps them back to vertex ids when batch_distances() filled
+// the matrix.
+struct DistanceMatrix {
+  vector<int> sources;
+  int num_vertices = 0;
+  vector<int> distances;
+  vector<int> vertex_ids;
+
+  int at(int row, int vertex) const {
+    return distances[size_t(row) * num_vertices + vertex];
+  }
+};
+
+namespace graph_lib {
+  // Plain breadth-first search from one dense index.
+  vector<int> bfs_distances(const Adjacency& out, int source) {
+    vector<int> distances(out.offsets.size() - 1, -1);
+    vector<int> queue(1, source);
+    distances[source] = 0;
+    for (size_t head = 0; head < queue.size(); head++) {
+      int u = queue[head];
+      for (const int* v = out.begin(u); v != out.end(u); v++) {
+	if (distances[*v] < 0) {
+	  distances[*v] = distances[u] + 1;
+	  queue.push_back(*v);
+	}
+      }
+    }
+    return distances;
+  }
+
+  // Multi-source BFS over one batch of at most 64 * kWords sources
+  // (sources[first] onwards), filling their rows of matrix. Every vertex
+  // carries one bit per source for "seen", "reached in this level" and
+  // "reached in the next level", so a single pass over the adjacency
+  // advances the whole batch by one level.
+  template<int kWords>
+  void multi_source_bfs_batch(const Adjacency& out, DistanceMatrix& matrix, size_t first) {
+    const int kWidth = 64 * kWords;
+    int num_vertices = matrix.num_vertices;
+    int batch_size = std::min<size_t>(kWidth, matrix.sources.size() - first);
+    vector<uint64_t> seen(size_t(num_vertices) * kWords);
+    vector<uint64_t> visit(size_t(num_vertices) * kWords);
+    vector<uint64_t> next(size_t(num_vertices) * kWords);
+    for (int i = 0; i < batch_size; i++) {
+      int source = matrix.sources[first + i];
+      if (source < 0) {
+	continue;
+      }
+      seen[size_t(source) * kWords + i / 64] |= uint64_t(1) << (i % 64);
+      visit[size_t(source) * kWords + i / 64] |= uint64_t(1) << (i % 64);
+      matrix.distances[(first + i) * num_vertices + source] = 0;
+    }
+    for (int level = 1; ; level++) {
+      for (int u = 0; u < num_vertices; u++) {
+	const uint64_t* from = &visit[size_t(u) * kWords];
+	uint64_t any = 0;
+	for (int k = 0; k < kWords; k++) {
+	  any |= from[k];
+	}
+	if (any == 0) {
+	  continue;
+	}
+	for (const int* v = out.begin(u); v != out.end(u); v++) {
+	  uint64_t* to = &next[size_t(*v) * kWords];
+	  for (int k = 0; k < kWords; k++) {
+	    to[k] |= from[k];
+	  }
+	}
+      }
+      bool active = false;
+      for (int v = 0; v < num_vertices; v++) {
+	for (int k = 0; k < kWords; k++) {
+	  size_t word = size_t(v) * kWords + k;
+	  uint64_t reached = next[word] & ~seen[word];
+	  next[word] = 0;
+	  visit[word] = reached;
+	  if (reached == 0) {
+	    continue;
+	  }
+	  seen[word] |= reached;
+	  active = true;
+	  for (; reached; reached &= reached - 1) {
+	    size_t row = first + 64 * k + __builtin_ctzll(reached);
+	    matrix.distances[row * num_vertices + v] = level;
+	  }
+	}
+      }
+      if (!active) {
+	break;
+      }
+    }
+  }
+
+  // Distances from every source (dense indices; -1 for none) to every
+  // vertex of cg. Sources are processed in batches of 64 * kWords (64 or
+  // 256 make sense), and batches are spread over num_threads threads.
+  template<int kWords = 4>
+  DistanceMatrix multi_source_bfs(const CompactGraph& cg, const vector<int>& sources, int num_threads = 0) {
+    const size_t kWidth = 64 * kWords;
+    DistanceMatrix matrix;
+    matrix.sources = sources;
+    matrix.num_vertices = cg.vertex_count();
+    matrix.distances.assign(sources.size() * cg.vertex_count(), -1);
+    Adjacency out = cg.out_edges();
+    size_t num_batches = (sources.size() + kWidth - 1) / kWidth;
+    parallel_for(num_batches, std::min<size_t>(thread_count(num_threads), num_batches),
+		 [&](size_t begin, size_t end, int) {
+      for (size_t batch = begin; batch < end; batch++) {
+	multi_source_bfs_batch<kWords>(out, matrix, batch * kWidth);
+      }
+    });
+    return matrix;
+  }
+
+  // Distances from each of sources to every vertex of cg, by vertex id. A
+  // source that is not in the graph gets a row of -1.
+  DistanceMatrix batch_distances(const CompactGraph& cg, const vector<Vertex*>& sources, int num_threads = 0) {
+    vector<int> indices;
+    for (const Vertex* source : sources) {
+      indices.push_back(cg.index(source->value().second));
+    }
+    DistanceMatrix matrix = multi_source_bfs(cg, indices, num_threads);
+    for (int v = 0; v < cg.vertex_count(); v++) {
+      matrix.vertex_ids.push_back(cg.id(v));
+    }
+    return matrix;
+  }
+
+  DistanceMatrix batch_distances(Graph<Vertex*, Edge*>& g, const vector<Vertex*>& sources, int num_threads = 0) {
+    return batch_distances(compact(g), sources, num_threads);
+  }
+}
@@ -0,0 +1,165 @@
+struct PropagationOptions {
+  // Stop once the L1 change of the scores in one iteration drops below
+  // tolerance, or after max_iterations, whichever comes first.
+  float tolerance = 1e-6;
+  int max_iterations = 100;
+  int num_threads = 0;
+};
+
+struct PropagationStats {
+  int iterations = 0;
+  double delta = 0;
+  double seconds = 0;
+
+  double seconds_per_iteration() const {
+    return iterations > 0 ? seconds / iterations : 0;
+  }
+  // Edges traversed per second, given the number of edges in the graph.
+  double edges_per_second(size_t num_edges) const {
+    return seconds > 0 ? iterations * double(num_edges) / seconds : 0;
+  }
+};
+
+// PageRank as a propagation policy: every vertex splits its rank evenly
+// over its out-edges, and the rank of dangling vertices (no out-edges)
+// is spread evenly over the whole graph.
+class PageRank {
+ public:
+  PageRank(const Adjacency& out, float damping) : damping_(damping) {
+    num_vertices_ = out.offsets.size() - 1;
+    inverse_degree_.resize(num_vertices_);
+    for (int v = 0; v < num_vertices_; v++) {
+      if (out.degree(v) == 0) {
+	dangling_.push_back(v);
+      } else {
+	inverse_degree_[v] = 1.0f / out.degree(v);
+      }
+    }
+  }
+  void prepare(const vector<float>& ranks) {
+    float dangling_rank = 0;
+    for (int v : dangling_) {
+      dangling_rank += ranks[v];
+    }
+    base_ = (1 - damping_ + damping_ * dangling_rank) / num_vertices_;
+  }
+  float scatter(int u, float rank) const {
+    return rank * inverse_degree_[u];
+  }
+  float apply(int, float gathered) const {
+    return base_ + damping_ * gathered;
+  }
+
+ private:
+  float damping_;
+  int num_vertices_;
+  float base_ = 0;
+  vector<float> inverse_degree_;
+  vector<int> dangling_;
+};
+
+namespace graph_lib {
+  // Splits the vertices into num_parts contiguous ranges with roughly the
+  // same number of edges each; part t is [bounds[t], bounds[t + 1]).
+  vector<int> partition_by_edges(const Adjacency& adjacency, int num_parts) {
+    int num_vertices = adjacency.offsets.size() - 1;
+    size_t num_edges = adjacency.targets.size();
+    vector<int> bounds(num_parts + 1, num_vertices);
+    bounds[0] = 0;
+    for (int t = 1; t < num_parts; t++) {
+      size_t target = num_edges * t / num_parts;
+      bounds[t] = std::lower_bound(adjacency.offsets.begin(), adjacency.offsets.end() - 1, target)
+	- adjacency.offsets.begin();
+    }
+    return bounds;
+  }
+
+  // Pull-based iterative propagation over the in-edges of a compacted
+  // graph. Every iteration the policy first sees the current scores
+  // (prepare), then each vertex u publishes scatter(u, scores[u]), and
+  // each vertex v gathers the sum of what its predecessors published and
+  // turns it into its next score with apply(v, sum). Vertices are split
+  // between threads by in-edge count, and each thread only ever writes
+  // its own range of the float arrays.
+  //
+  // The threads are started once for the whole run. A barrier separates
+  // scatter from gather, and the last thread to finish gathering does the
+  // serial part (swap, convergence check, prepare) before the next
+  // iteration. stats.seconds covers the iterations only.
+  template<typename Policy>
+  PropagationStats propagate(const Adjacency& in, vector<float>& scores, Policy& policy,
+			     const PropagationOptions& options = PropagationOptions()) {
+    PropagationStats stats;
+    int num_vertices = in.offsets.size() - 1;
+    int num_threads = std::max(1, std::min(thread_count(options.num_threads), num_vertices));
+    vector<int> bounds = partition_by_edges(in, num_threads);
+    vector<float> contributions(num_vertices);
+    vector<float> next(num_vertices);
+    vector<double> deltas(num_threads);
+    if (options.max_iterations <= 0) {
+      return stats;
+    }
+    Barrier barrier(num_threads);
+    bool done = false;
+    std::chrono::steady_clock::time_point start;
+    auto finish_iteration = [&]() {
+      scores.swap(next);
+      stats.iterations++;
+      stats.delta = 0;
+      for (double delta : deltas) {
+	stats.delta += delta;
+      }
+      done = stats.delta < options.tolerance || stats.iterations >= options.max_iterations;
+      if (done) {
+	stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      } else {
+	policy.prepare(scores);
+      }
+    };
+    parallel_for(num_threads, num_threads, [&](size_t t, size_t, int) {
+      barrier.wait([&]() {
+	start = std::chrono::steady_clock::now();
+	policy.prepare(scores);
+      });
+      while (!done) {
+	for (int u = bounds[t]; u < bounds[t + 1]; u++) {
+	  contributions[u] = policy.scatter(u, scores[u]);
+	}
+	barrier.wait();
+	double delta = 0;
+	for (int v = bounds[t]; v < bounds[t + 1]; v++) {
+	  float gathered = 0;
+	  for (const int* u = in.begin(v); u != in.end(v); u++) {
+	    gathered += contributions[*u];
+	  }
+	  next[v] = policy.apply(v, gathered);
+	  delta += std::abs(next[v] - scores[v]);
+	}
+	deltas[t] = delta;
+	barrier.wait(finish_iteration);
+      }
+    });
+    return stats;
+  }
+
+  // PageRank of every dense index of cg, written to ranks.
+  PropagationStats pagerank(const CompactGraph& cg, vector<float>& ranks, float damping = 0.85,
+			    const PropagationOptions& options = PropagationOptions()) {
+    PageRank policy(cg.out_edges(), damping);
+    ranks.assign(cg.vertex_count(), 1.0f / std::max(1, cg.vertex_count()));
+    return propagate(cg.in_edges(), ranks, policy, options);
+  }
+
+  // Maps every vertex id in g to its PageRank; the ranks sum to 1.
+  std::map<int, float> pagerank(Graph<Vertex*, Edge*>& g, float damping = 0.85,
+				const PropagationOptions& options = PropagationOptions()) {
+    CompactGraph cg = compact(g);
+    vector<float> ranks;
+    pagerank(cg, ranks, damping, options);
+    std::map<int, float> ranks_by_id;
+    for (int v = 0; v < cg.vertex_count(); v++) {
+      ranks_by_id.insert(std::pair<int, float>(cg.id(v), ranks[v]));
+    }
+    return ranks_by_id;
+  }
+}
@@ -0,0 +1,95 @@
+// Vertex orderings that put vertices which are used together next to
+// each other, so that traversals over the dense indices touch fewer
+// cache lines. kFirstSeen is the order CompactGraph starts with.
+enum class Ordering {
+  kFirstSeen,
+  kDegree,
+  kBfs,
+  kReverseCuthillMcKee,
+};
+
+namespace graph_lib {
+  // Vertices sorted by how many edges (in either direction) they have.
+  vector<int> vertices_by_degree(const Adjacency& undirected, bool ascending) {
+    vector<int> order(undirected.offsets.size() - 1);
+    for (size_t v = 0; v < order.size(); v++) {
+      order[v] = v;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int u, int v) {
+      return ascending ? undirected.degree(u) < undirected.degree(v) : undirected.degree(u) > undirected.degree(v);
+    });
+    return order;
+  }
+
+  // Breadth-first order of every component, taking the start vertices in
+  // the order given. With by_degree, the unvisited neighbors of a vertex
+  // are queued from lowest to highest degree (Cuthill-McKee).
+  vector<int> breadth_first_order(const Adjacency& undirected, const vector<int>& starts, bool by_degree) {
+    int num_vertices = undirected.offsets.size() - 1;
+    vector<int> order;
+    order.reserve(num_vertices);
+    vector<bool> visited(num_vertices);
+    for (int start : starts) {
+      if (visited[start]) {
+	continue;
+      }
+      visited[start] = true;
+      order.push_back(start);
+      for (size_t head = order.size() - 1; head < order.size(); head++) {
+	int u = order[head];
+	size_t first_queued = order.size();
+	for (const int* v = undirected.begin(u); v != undirected.end(u); v++) {
+	  if (!visited[*v]) {
+	    visited[*v] = true;
+	    order.push_back(*v);
+	  }
+	}
+	if (by_degree) {
+	  std::stable_sort(order.begin() + first_queued, order.end(), [&](int x, int y) {
+	    return undirected.degree(x) < undirected.degree(y);
+	  });
+	}
+      }
+    }
+    return order;
+  }
+
+  // The permutation that relabel() needs to put cg in the given order:
+  // order[i] is the current index of the vertex that should become i.
+  vector<int> ordering(const CompactGraph& cg, Ordering kind) {
+    Adjacency undirected = cg.undirected_edges();
+    switch (kind) {
+    case Ordering::kDegree:
+      // Hubs first: they are touched by most edges, so they share the
+      // hottest cache lines.
+      return vertices_by_degree(undirected, false);
+    case Ordering::kBfs:
+      return breadth_first_order(undirected, vertices_by_degree(undirected, false), false);
+    case Ordering::kReverseCuthillMcKee: {
+      // Start every component from a low-degree (peripheral) vertex, then
+      // reverse the whole thing, which keeps the bandwidth of the
+      // adjacency matrix small.
+      vector<int> order = breadth_first_order(undirected, vertices_by_degree(undirected, true), true);
+      std::reverse(order.begin(), order.end());
+      return order;
+    }
+    case Ordering::kFirstSeen:
+      break;
+    }
+    vector<int> order(cg.vertex_count());
+    for (size_t v = 0; v < order.size(); v++) {
+      order[v] = v;
+    }
+    return order;
+  }
+
+  void reorder(CompactGraph& cg, Ordering kind) {
+    cg.relabel(ordering(cg, kind));
+  }
+
+  CompactGraph compact(Graph<Vertex*, Edge*>& g, Ordering kind) {
+    CompactGraph cg = compact(g);
+    reorder(cg, kind);
+    return cg;
+  }
+}
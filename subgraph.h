@@ -0,0 +1,137 @@
+namespace graph_lib {
+  // The dense indices within k hops (along out-edges) of the seeds, seeds
+  // included, in the order they are reached. A bitset keeps each vertex
+  // out of the frontier after its first visit.
+  vector<int> k_hop(const Adjacency& out, const vector<int>& seeds, int k) {
+    vector<uint64_t> visited((out.offsets.size() - 1 + 63) / 64);
+    auto visit = [&](int v) {
+      uint64_t bit = uint64_t(1) << (v % 64);
+      bool first = !(visited[v / 64] & bit);
+      visited[v / 64] |= bit;
+      return first;
+    };
+    vector<int> reached;
+    for (int seed : seeds) {
+      if (seed >= 0 && visit(seed)) {
+	reached.push_back(seed);
+      }
+    }
+    size_t frontier = 0;
+    for (int hop = 0; hop < k && frontier < reached.size(); hop++) {
+      size_t end = reached.size();
+      for (; frontier < end; frontier++) {
+	int u = reached[frontier];
+	for (const int* v = out.begin(u); v != out.end(u); v++) {
+	  if (visit(*v)) {
+	    reached.push_back(*v);
+	  }
+	}
+      }
+    }
+    return reached;
+  }
+
+  // Ids of the vertices of g within k hops of the seeds.
+  vector<int> k_hop_neighborhood(Graph<Vertex*, Edge*>& g, const vector<Vertex*>& seeds, int k) {
+    CompactGraph cg = compact(g);
+    vector<int> indices;
+    for (const Vertex* seed : seeds) {
+      indices.push_back(cg.index(seed->value().second));
+    }
+    vector<int> ids;
+    for (int v : k_hop(cg.out_edges(), indices, k)) {
+      ids.push_back(cg.id(v));
+    }
+    return ids;
+  }
+
+  // How many vertex records induced_subgraph() may add to a result that
+  // already holds num_edges edges: a Tree, like Tree::add, only takes one
+  // while it is empty.
+  template<typename G>
+  size_t max_vertex_records(const G&, size_t) {
+    return ~size_t(0);
+  }
+
+  size_t max_vertex_records(const Tree&, size_t num_edges) {
+    return num_edges == 0 ? 1 : 0;
+  }
+
+  // The subgraph of g induced by the vertices with the given ids: every
+  // edge of g between two of them, in g's order, and a vertex record for
+  // those without such an edge. The result is simple if g is. Edges are
+  // copied by num_threads threads in one pass and handed to the new graph
+  // in bulk, without the per-edge cycle check of
+  // DirectedAcyclicGraph::add_edge, since any subgraph of an acyclic
+  // graph is acyclic.
+  //
+  // Ids that are not in g are ignored. For a Tree the edges are always
+  // copied, forests included, but vertex records follow the rule of
+  // Tree::add: the first member without edges is kept only if no edge was
+  // copied, and any others are dropped.
+  template<typename G>
+  G induced_subgraph(G& g, const vector<int>& ids, int num_threads = 0) {
+    std::unordered_map<int, int> members;
+    for (int id : ids) {
+      members.insert(std::pair<int, int>(id, members.size()));
+    }
+    const vector<Edge>& edges = g.edges();
+    num_threads = std::max<int>(1, std::min<size_t>(thread_count(num_threads), edges.size() / 1024 + 1));
+    vector<vector<Edge>> batches(num_threads);
+    vector<vector<bool>> covered(num_threads, vector<bool>(members.size()));
+    parallel_for(edges.size(), num_threads, [&](size_t begin, size_t end, int thread) {
+      for (size_t i = begin; i < end; i++) {
+	const Edge& e = edges[i];
+	if (!e.get_source() || !e.get_dest()) {
+	  continue;
+	}
+	auto source = members.find(e.get_source()->value().second);
+	auto dest = members.find(e.get_dest()->value().second);
+	if (source != members.end() && dest != members.end()) {
+	  batches[thread].push_back(e);
+	  covered[thread][source->second] = true;
+	  covered[thread][dest->second] = true;
+	}
+      }
+    });
+    // Members that are not on any copied edge still need to show up.
+    vector<bool> isolated(members.size(), true);
+    for (const vector<bool>& thread_covered : covered) {
+      for (size_t m = 0; m < members.size(); m++) {
+	isolated[m] = isolated[m] && !thread_covered[m];
+      }
+    }
+    vector<Edge> records;
+    bool any_isolated = std::find(isolated.begin(), isolated.end(), true) != isolated.end();
+    for (size_t i = 0; any_isolated && i < edges.size(); i++) {
+      const Edge& e = edges[i];
+      for (const Vertex* v : {e.get_source().get(), e.get_dest().get()}) {
+	if (!v) {
+	  continue;
+	}
+	auto member = members.find(v->value().second);
+	if (member != members.end() && isolated[member->second]) {
+	  isolated[member->second] = false;
+	  Edge record;
+	  record.set_source(*v);
+	  records.push_back(std::move(record));
+	}
+      }
+    }
+    G subgraph(g.is_simple());
+    size_t num_edges = 0;
+    for (const vector<Edge>& batch : batches) {
+      num_edges += batch.size();
+    }
+    records.resize(std::min(records.size(), max_vertex_records(subgraph, num_edges)));
+    batches.push_back(std::move(records));
+    subgraph.append_edges(batches);
+    return subgraph;
+  }
+
+  // The subgraph of g induced by the vertices within k hops of the seeds.
+  template<typename G>
+  G k_hop_subgraph(G& g, const vector<Vertex*>& seeds, int k, int num_threads = 0) {
+    return induced_subgraph(g, k_hop_neighborhood(g, seeds, k), num_threads);
+  }
+}
@@ -0,0 +1,364 @@
+// A read-only copy of a Tree in about 2.4 bits per node plus labels. The
+// shape is stored as balanced parentheses: walking the tree in preorder,
+// an open bit (1) when a node is entered and a close bit (0) when it is
+// left. Ids are stored in the same preorder.
+//
+// A node is the position of its open parenthesis, so root() is 0 and -1
+// stands for "no such node". Navigation relies on the excess, the number
+// of opens minus closes up to and including a position:
+//   depth(v) is excess(v) - 1, read from a rank directory in O(1);
+//   first_child(v) is v + 1 if that is an open bit;
+//   next_sibling(v) and subtree_size(v) need the matching close, the
+//   first position after v whose excess drops to excess(v) - 1;
+//   parent(v) is the position after the last one before v whose excess
+//   is excess(v) - 2.
+// Those searches scan a byte at a time (with tables of each byte's excess
+// and minimum prefix excess) inside a 512-bit block, and skip other blocks
+// with a tree of per-block minimum excesses: O(log(n / 256)), which stays
+// within a few cache lines for any practical tree.
+//
+// A Tree is stored as a DAG, so a vertex may have several parents: it is
+// placed under the first one that reaches it in preorder. Vertices without
+// parents become consecutive roots of a forest, each the next sibling of
+// the previous one.
+class SuccinctTree {
+ public:
+  SuccinctTree(const CompactGraph& cg) {
+    int n = cg.vertex_count();
+    Adjacency children = cg.out_edges();
+    vector<int> in_degree(n);
+    for (int child : children.targets) {
+      in_degree[child]++;
+    }
+    num_bits_ = 2 * n;
+    bits_.assign((num_bits_ + 63) / 64, 0);
+    ids_.reserve(n);
+    vector<bool> placed(n);
+    int position = 0;
+    // Iterative preorder walk: (vertex, next child offset) per level.
+    vector<std::pair<int, size_t>> stack;
+    auto enter = [&](int v) {
+      placed[v] = true;
+      bits_[position / 64] |= uint64_t(1) << (position % 64);
+      position++;
+      ids_.push_back(cg.id(v));
+      stack.push_back(std::pair<int, size_t>(v, children.offsets[v]));
+    };
+    // Roots first; the second pass only finds vertices on cycles, which
+    // a Tree built with append_edges() could contain.
+    for (int pass = 0; pass < 2; pass++) {
+      for (int root = 0; root < n; root++) {
+	if (placed[root] || (pass == 0 && in_degree[root] > 0)) {
+	  continue;
+	}
+	enter(root);
+	while (!stack.empty()) {
+	  std::pair<int, size_t>& top = stack.back();
+	  if (top.second == children.offsets[top.first + 1]) {
+	    position++;
+	    stack.pop_back();
+	    continue;
+	  }
+	  int child = children.targets[top.second++];
+	  if (!placed[child]) {
+	    enter(child);
+	  }
+	}
+      }
+    }
+    for (int i = 0; i < n; i++) {
+      index_.push_back(std::pair<int, int>(ids_[i], i));
+    }
+    std::sort(index_.begin(), index_.end());
+    build_directories_();
+  }
+
+  // Number of nodes.
+  int size() const {
+    return ids_.size();
+  }
+
+  int root() const {
+    return num_bits_ > 0 ? 0 : -1;
+  }
+
+  int parent(int v) const {
+    int before = backward_search_(v, excess_(v) - 2);
+    return before == kNotFound ? -1 : before + 1;
+  }
+
+  int first_child(int v) const {
+    return v + 1 < num_bits_ && open_(v + 1) ? v + 1 : -1;
+  }
+
+  int next_sibling(int v) const {
+    int close = find_close_(v);
+    return close + 1 < num_bits_ && open_(close + 1) ? close + 1 : -1;
+  }
+
+  // Nodes in the subtree of v, v included.
+  int subtree_size(int v) const {
+    return (find_close_(v) - v + 1) / 2;
+  }
+
+  // Roots have depth 0.
+  int depth(int v) const {
+    return excess_(v) - 1;
+  }
+
+  // Rank of v in preorder.
+  int preorder(int v) const {
+    return rank_(v);
+  }
+
+  // The node with preorder rank i.
+  int node(int i) const {
+    // The last block starting with at most i opens before it.
+    int block = std::upper_bound(block_ranks_.begin(), block_ranks_.end(), uint32_t(i)) - block_ranks_.begin() - 1;
+    int remaining = i - block_ranks_[block];
+    for (size_t w = size_t(block) * kBlockWords; ; w++) {
+      int count = __builtin_popcountll(bits_[w]);
+      if (remaining < count) {
+	uint64_t word = bits_[w];
+	for (; remaining > 0; remaining--) {
+	  word &= word - 1;
+	}
+	return w * 64 + __builtin_ctzll(word);
+      }
+      remaining -= count;
+    }
+  }
+
+  int id(int v) const {
+    return ids_[rank_(v)];
+  }
+
+  // The node of a vertex id, or -1 if it is not in the tree.
+  int find(int id) const {
+    auto it = std::lower_bound(index_.begin(), index_.end(), std::pair<int, int>(id, 0));
+    return it != index_.end() && it->first == id ? node(it->second) : -1;
+  }
+
+  // Memory held by the representation, labels included.
+  size_t bytes() const {
+    return bits_.capacity() * sizeof(uint64_t) + block_ranks_.capacity() * sizeof(uint32_t)
+      + min_excess_.capacity() * sizeof(int) + ids_.capacity() * sizeof(int)
+      + index_.capacity() * sizeof(std::pair<int, int>);
+  }
+
+  // Bits of the parentheses and their directories alone, per node.
+  double bits_per_node() const {
+    size_t shape = bits_.size() * sizeof(uint64_t) + block_ranks_.size() * sizeof(uint32_t)
+      + min_excess_.size() * sizeof(int);
+    return size() > 0 ? 8.0 * shape / size() : 0;
+  }
+
+ private:
+  static constexpr int kBlockBits = 512;
+  static constexpr int kBlockWords = kBlockBits / 64;
+  static constexpr int kNotFound = -2;
+  // Minimum excess of the padding leaves of min_excess_.
+  static constexpr int kNoMinimum = 1 << 30;
+
+  // Excess change over a byte, and the minimum excess after each of its
+  // bits (lowest bit first), relative to the excess before it.
+  struct ByteTable {
+    int8_t excess[256];
+    int8_t min_excess[256];
+
+    ByteTable() {
+      for (int byte = 0; byte < 256; byte++) {
+	int excess = 0, min_excess = 8;
+	for (int bit = 0; bit < 8; bit++) {
+	  excess += (byte >> bit) & 1 ? 1 : -1;
+	  min_excess = std::min(min_excess, excess);
+	}
+	this->excess[byte] = excess;
+	this->min_excess[byte] = min_excess;
+      }
+    }
+  };
+
+  vector<uint64_t> bits_;
+  int num_bits_ = 0;
+  // Opens before each block, and the total at the end.
+  vector<uint32_t> block_ranks_;
+  // Binary tree over blocks, leaves at [num_leaves_, 2 * num_leaves_):
+  // the minimum excess within each subtree's blocks.
+  vector<int> min_excess_;
+  int num_leaves_ = 1;
+  vector<int> ids_;
+  vector<std::pair<int, int>> index_;
+
+  static const ByteTable& table_() {
+    static const ByteTable table;
+    return table;
+  }
+
+  void build_directories_() {
+    int num_blocks = (num_bits_ + kBlockBits - 1) / kBlockBits;
+    block_ranks_.assign(num_blocks + 1, 0);
+    while (num_leaves_ < num_blocks) {
+      num_leaves_ *= 2;
+    }
+    min_excess_.assign(2 * num_leaves_, kNoMinimum);
+    int excess = 0;
+    uint32_t opens = 0;
+    for (int block = 0; block < num_blocks; block++) {
+      block_ranks_[block] = opens;
+      int end = std::min(num_bits_, (block + 1) * kBlockBits);
+      for (int p = block * kBlockBits; p < end; p++) {
+	excess += open_(p) ? 1 : -1;
+	opens += open_(p);
+	min_excess_[num_leaves_ + block] = std::min(min_excess_[num_leaves_ + block], excess);
+      }
+    }
+    block_ranks_[num_blocks] = opens;
+    for (int node = num_leaves_ - 1; node > 0; node--) {
+      min_excess_[node] = std::min(min_excess_[2 * node], min_excess_[2 * node + 1]);
+    }
+  }
+
+  bool open_(int p) const {
+    return (bits_[p / 64] >> (p % 64)) & 1;
+  }
+
+  uint8_t byte_(int p) const {
+    return uint8_t(bits_[p / 64] >> (p % 64));
+  }
+
+  // Opens in [0, p).
+  int rank_(int p) const {
+    int block = p / kBlockBits;
+    int rank = block_ranks_[block];
+    for (int w = block * kBlockWords; w < p / 64; w++) {
+      rank += __builtin_popcountll(bits_[w]);
+    }
+    if (p % 64) {
+      rank += __builtin_popcountll(bits_[p / 64] & ((uint64_t(1) << (p % 64)) - 1));
+    }
+    return rank;
+  }
+
+  // Opens minus closes in [0, p].
+  int excess_(int p) const {
+    return 2 * rank_(p + 1) - (p + 1);
+  }
+
+  int find_close_(int v) const {
+    return forward_search_(v, excess_(v) - 1);
+  }
+
+  // The first p in [q, end) whose excess is at most target, given the
+  // excess before q, or kNotFound.
+  int scan_forward_(int q, int end, int excess, int target) const {
+    const ByteTable& table = table_();
+    for (; q < end && q % 8 != 0; q++) {
+      excess += open_(q) ? 1 : -1;
+      if (excess <= target) {
+	return q;
+      }
+    }
+    for (; q + 8 <= end; q += 8) {
+      uint8_t byte = byte_(q);
+      if (excess + table.min_excess[byte] <= target) {
+	break;
+      }
+      excess += table.excess[byte];
+    }
+    for (; q < end; q++) {
+      excess += open_(q) ? 1 : -1;
+      if (excess <= target) {
+	return q;
+      }
+    }
+    return kNotFound;
+  }
+
+  // The last p in [begin, q] whose excess is at most target, given the
+  // excess at q, or kNotFound. begin must be a multiple of 8.
+  int scan_backward_(int q, int begin, int excess, int target) const {
+    const ByteTable& table = table_();
+    for (; q >= begin && q % 8 != 7; q--) {
+      if (excess <= target) {
+	return q;
+      }
+      excess -= open_(q) ? 1 : -1;
+    }
+    for (; q - 7 >= begin; q -= 8) {
+      uint8_t byte = byte_(q - 7);
+      if (excess - table.excess[byte] + table.min_excess[byte] <= target) {
+	break;
+      }
+      excess -= table.excess[byte];
+    }
+    for (; q >= begin; q--) {
+      if (excess <= target) {
+	return q;
+      }
+      excess -= open_(q) ? 1 : -1;
+    }
+    return kNotFound;
+  }
+
+  // The first position after p whose excess is at most target (and so,
+  // as excess moves by one, exactly target), or kNotFound.
+  int forward_search_(int p, int target) const {
+    int block = p / kBlockBits;
+    int end = std::min(num_bits_, (block + 1) * kBlockBits);
+    int found = scan_forward_(p + 1, end, excess_(p), target);
+    if (found != kNotFound) {
+      return found;
+    }
+    // Climb to the first subtree to the right whose minimum reaches
+    // target, then descend to its leftmost such block.
+    int node = num_leaves_ + block;
+    for (; node > 1; node /= 2) {
+      if (node % 2 == 0 && min_excess_[node + 1] <= target) {
+	node++;
+	while (node < num_leaves_) {
+	  node = min_excess_[2 * node] <= target ? 2 * node : 2 * node + 1;
+	}
+	block = node - num_leaves_;
+	int begin = block * kBlockBits;
+	end = std::min(num_bits_, begin + kBlockBits);
+	return scan_forward_(begin, end, 2 * int(block_ranks_[block]) - begin, target);
+      }
+    }
+    return kNotFound;
+  }
+
+  // The last position before p whose excess is at most target; -1 if
+  // there is none but target >= 0 (the excess "before the start"), and
+  // kNotFound otherwise.
+  int backward_search_(int p, int target) const {
+    int none = target >= 0 ? -1 : kNotFound;
+    if (p == 0) {
+      return none;
+    }
+    int block = (p - 1) / kBlockBits;
+    int found = scan_backward_(p - 1, block * kBlockBits, excess_(p - 1), target);
+    if (found != kNotFound) {
+      return found;
+    }
+    int node = num_leaves_ + block;
+    for (; node > 1; node /= 2) {
+      if (node % 2 == 1 && min_excess_[node - 1] <= target) {
+	node--;
+	while (node < num_leaves_) {
+	  node = min_excess_[2 * node + 1] <= target ? 2 * node + 1 : 2 * node;
+	}
+	block = node - num_leaves_;
+	int last = (block + 1) * kBlockBits - 1;
+	return scan_backward_(last, block * kBlockBits, excess_(last), target);
+      }
+    }
+    return none;
+  }
+};
+
+namespace graph_lib {
+  SuccinctTree succinct(Tree& tree) {
+    return SuccinctTree(compact(tree));
+  }
+}
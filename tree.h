@@ -3,11 +3,18 @@ class Tree {
   Tree() {
     dag_ = std::make_unique<DirectedAcyclicGraph>();
   }
+  // See DirectedGraph(bool simple).
+  Tree(bool simple) {
+    dag_ = std::make_unique<DirectedAcyclicGraph>(simple);
+  }
   Tree(const Tree& tree) noexcept {
     if (tree.dag_.get()) {
       dag_ = std::make_unique<DirectedAcyclicGraph>(*(tree.dag_.get()));
     }
   } 
+  bool is_simple() const {
+    return dag_.get()->is_simple();
+  }
   bool add(const Vertex* u) {
     if (get_adjacency_list().size() > 0) {
       // Only allowed to add when the tree is empty.
@@ -21,12 +28,26 @@ class Tree {
   bool add_edge(const Edge* edge) {
     return dag_.get()->add_edge(edge);
   }
+  // See DirectedAcyclicGraph::append_edges.
+  void append_edges(vector<vector<Edge>>& batches) {
+    dag_.get()->append_edges(batches);
+  }
   vector<Edge> get_adjacency_list() {
     return dag_.get()->get_adjacency_list();
   }
+  const vector<Edge>& edges() const {
+    return dag_.get()->edges();
+  }
+  // See DirectedGraph::set_adjacency_filter.
+  void set_adjacency_filter(double false_positive_rate) {
+    dag_.get()->set_adjacency_filter(false_positive_rate);
+  }
   bool are_adjacent(const Vertex* u, const Vertex* v) {
     return dag_.get()->are_adjacent(u, v);
   }
+  vector<bool> are_adjacent(const vector<std::pair<const Vertex*, const Vertex*>>& pairs) {
+    return dag_.get()->are_adjacent(pairs);
+  }
   int edge_count() {
     return dag_.get()->edge_count();
   }